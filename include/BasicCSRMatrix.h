@@ -0,0 +1,120 @@
+#ifndef BASICCSRMATRIX_H
+#define BASICCSRMATRIX_H
+
+#include "CSRMatrix.h"
+#include "Types.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class BasicCSRMatrix
+ * @brief Boolean CSR matrix with compile-time column index and row offset
+ * types.
+ *
+ * CSRMatrix fixes both to int, capping a matrix at 2^31 - 1 non-zeros.
+ * BasicCSRMatrix<int32_t, int64_t> (WideCSRMatrix) lifts that cap for
+ * billion-edge products, while BasicCSRMatrix<uint16_t, int32_t>
+ * (NarrowCSRMatrix) halves the index bytes of matrices with at most 65536
+ * columns, such as tiles. Kernels are instantiated per type pair in
+ * BasicCSRMatrix.cpp, so each layout gets its own specialized loop.
+ *
+ * @tparam Index Column index type
+ * @tparam Offset Row offset type, wide enough for the number of non-zeros
+ */
+template <typename Index, typename Offset> class BasicCSRMatrix {
+public:
+  /**
+   * @brief Converts a CSRMatrix to this layout.
+   *
+   * @param csr The matrix to convert
+   *
+   * @throws std::invalid_argument if csr has values.
+   * @throws std::overflow_error if a column does not fit Index, or the
+   * number of non-zeros does not fit Offset.
+   */
+  explicit BasicCSRMatrix(const CSRMatrix &csr);
+
+  /**
+   * @brief Takes ownership of existing CSR arrays.
+   *
+   * Column indices must already be sorted and distinct within each row.
+   *
+   * @param rowPtr Row pointers, of size M + 1
+   * @param colIdx Column index of every non-zero
+   * @param M Number of rows in matrix
+   * @param N Number of cols in matrix
+   *
+   * @throws std::invalid_argument if the array sizes do not match M or each
+   * other.
+   * @throws std::overflow_error if N columns do not fit Index.
+   */
+  BasicCSRMatrix(std::vector<Offset> rowPtr, std::vector<Index> colIdx, int M,
+                 int N);
+
+  /**
+   * @brief Converts back to a CSRMatrix.
+   * @return CSRMatrix holding the same entries
+   *
+   * @throws std::overflow_error if the matrix has 2^31 or more non-zeros.
+   */
+  [[nodiscard]] CSRMatrix toCSR() const;
+
+  /**
+   * @brief Performs row-wise sparse matrix multiplication (this × right)
+   * with Gustavson's algorithm, in this layout.
+   *
+   * @param right The right-hand matrix in the multiplication (this × right)
+   * @return Product in the same layout
+   *
+   * @throws std::invalid_argument on matrix dimension mismatch.
+   * @throws std::overflow_error if the product's non-zeros do not fit
+   * Offset.
+   */
+  [[nodiscard]] BasicCSRMatrix naiveMatmul(const BasicCSRMatrix &right) const;
+
+  /**
+   * @brief Returns the row pointers (size numRows + 1).
+   * @return Reference to the internal rowPtr vector.
+   */
+  [[nodiscard]] const std::vector<Offset> &getRowPtr() const;
+
+  /**
+   * @brief Returns the column index of every non-zero, sorted within rows.
+   * @return Reference to the internal colIdx vector.
+   */
+  [[nodiscard]] const std::vector<Index> &getColIdx() const;
+
+  /**
+   * @brief Returns a vector of non-zero (row, col) coordinates.
+   * @return Vector of Coords listing non-zero indices in the matrix.
+   */
+  [[nodiscard]] std::vector<Coord> getCoords() const;
+
+  /**
+   * @brief Returns the number of non-zero entries.
+   */
+  [[nodiscard]] Offset nnz() const;
+
+  /**
+   * @brief Returns the shape (numRows, numCols) of the matrix.
+   * @return std::pair<int, int> representing (rows, cols)
+   */
+  [[nodiscard]] std::pair<int, int> shape() const;
+
+private:
+  std::vector<Offset> rowPtr;
+  std::vector<Index> colIdx;
+
+  int M, N; // num rows, num cols
+};
+
+// 32-bit columns with 64-bit offsets, for products past 2^31 non-zeros.
+using WideCSRMatrix = BasicCSRMatrix<int32_t, int64_t>;
+
+// 16-bit columns, for matrices or tiles with at most 65536 columns.
+using NarrowCSRMatrix = BasicCSRMatrix<uint16_t, int32_t>;
+
+// 16-bit columns and offsets, for tiles of at most 65535 non-zeros.
+using TileCSRMatrix = BasicCSRMatrix<uint16_t, uint16_t>;
+
+#endif // BASICCSRMATRIX_H
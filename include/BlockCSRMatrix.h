@@ -0,0 +1,91 @@
+#ifndef BLOCKCSRMATRIX_H
+#define BLOCKCSRMATRIX_H
+
+#include "CSRMatrix.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class BlockCSRMatrix
+ * @brief Stores a boolean matrix as a CSR structure over bit-packed square
+ * tiles.
+ *
+ * Only non-empty tiles are stored. An 8×8 tile is a single 64-bit word with
+ * row r in byte r; a 64×64 tile is 64 words with row r in word r. Both use
+ * bit c for column c within the tile. Tile products run on whole words:
+ * AND/OR masks for 8×8 tiles, and one OR per set bit for 64×64 tiles.
+ */
+class BlockCSRMatrix {
+public:
+  /**
+   * @brief Packs a CSRMatrix into tiles.
+   *
+   * With tileSize 0, 64×64 tiles are used when the non-empty 64×64 blocks
+   * are dense enough to beat per-entry storage, and 8×8 tiles otherwise.
+   *
+   * @param csr The matrix to convert
+   * @param tileSize 8, 64, or 0 to choose from the matrix's block density
+   *
+   * @throws std::invalid_argument if tileSize is not 0, 8 or 64, or csr
+   * has values.
+   */
+  explicit BlockCSRMatrix(const CSRMatrix &csr, int tileSize = 0);
+
+  /**
+   * @brief Unpacks the tiles back into a CSRMatrix.
+   * @return CSRMatrix holding the same entries
+   *
+   * @throws std::overflow_error if the matrix has 2^31 or more entries.
+   */
+  [[nodiscard]] CSRMatrix toCSR() const;
+
+  /**
+   * @brief Performs block-row-wise sparse matrix multiplication
+   * (this × right), multiplying tile by tile with bitwise operations.
+   *
+   * Output tiles are accumulated densely per block row, with a marker per
+   * block column, and tiles that come out empty are dropped.
+   *
+   * @param right The right-hand matrix, packed with the same tile size
+   * @return BlockCSRMatrix representing the product
+   *
+   * @throws std::invalid_argument on matrix dimension mismatch or if the
+   * tile sizes differ.
+   */
+  [[nodiscard]] BlockCSRMatrix naiveMatmul(const BlockCSRMatrix &right) const;
+
+  /**
+   * @brief Returns the tile edge length, 8 or 64.
+   */
+  [[nodiscard]] int tileSize() const;
+
+  /**
+   * @brief Returns the number of stored tiles.
+   */
+  [[nodiscard]] size_t numTiles() const;
+
+  /**
+   * @brief Returns the number of non-zero entries, counted by popcount.
+   */
+  [[nodiscard]] size_t nnz() const;
+
+  /**
+   * @brief Returns the shape (numRows, numCols) of the matrix.
+   * @return std::pair<int, int> representing (rows, cols)
+   */
+  [[nodiscard]] std::pair<int, int> shape() const;
+
+private:
+  BlockCSRMatrix(int M, int N, int tileSize);
+
+  [[nodiscard]] int wordsPerTile() const;
+
+  std::vector<int> blockRowPtr;  // tiles of each block row, plus the end
+  std::vector<int> blockColIdx;  // block column of every tile
+  std::vector<uint64_t> tiles;   // wordsPerTile() words per tile
+
+  int M, N; // num rows, num cols
+  int T;    // tile edge length
+};
+
+#endif // BLOCKCSRMATRIX_H
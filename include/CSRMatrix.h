@@ -3,16 +3,24 @@
 
 #include <CoordListMatrix.h>
 
+#include "SpGEMMWorkspace.h"
 #include "Types.h"
 #include <string>
 #include <vector>
 
+struct BooleanSemiring;
+
 /**
  * @class CSRMatrix
  * @brief Stores a sparse matrix in Compressed-Sparse-Row format.
  */
 class CSRMatrix {
 public:
+  /**
+   * @brief Constructs an empty 0x0 matrix, e.g. as a multiplyInto() target.
+   */
+  CSRMatrix() : M(0), N(0) {}
+
   /**
    * @brief Loads non-zero entries from a Matrix Market (.mtx) file.
    *
@@ -34,12 +42,102 @@ public:
    */
   CSRMatrix(const std::vector<Coord> &coords, int M, int N);
 
+  /**
+   * @brief Takes ownership of existing CSR arrays, e.g. produced by a
+   * conversion from another format.
+   *
+   * Column indices must already be sorted and distinct within each row.
+   *
+   * @param rowPtr Row pointers, of size M + 1
+   * @param colIdx Column index of every non-zero
+   * @param M Number of rows in matrix
+   * @param N Number of cols in matrix
+   *
+   * @throws std::invalid_argument if the array sizes do not match M or each
+   * other.
+   */
+  CSRMatrix(std::vector<int> rowPtr, std::vector<int> colIdx, int M, int N);
+
+  /**
+   * @brief Takes ownership of existing CSR arrays together with a value per
+   * non-zero, for products over a semiring other than boolean.
+   *
+   * @param rowPtr Row pointers, of size M + 1
+   * @param colIdx Column index of every non-zero
+   * @param values Value of every non-zero, parallel to colIdx
+   * @param M Number of rows in matrix
+   * @param N Number of cols in matrix
+   *
+   * @throws std::invalid_argument if the array sizes do not match M or each
+   * other.
+   */
+  CSRMatrix(std::vector<int> rowPtr, std::vector<int> colIdx,
+            std::vector<double> values, int M, int N);
+
   /**
    * @brief Returns a vector of non-zero (row, col) coordinates.
    * @return Vector of Coords listing non-zero indices in the matrix.
    */
   std::vector<Coord> getCoords() const;
 
+  /**
+   * @brief Returns the row pointers (size numRows + 1).
+   * @return Reference to the internal rowPtr vector.
+   */
+  [[nodiscard]] const std::vector<int> &getRowPtr() const;
+
+  /**
+   * @brief Returns the column index of every non-zero, sorted within rows.
+   * @return Reference to the internal colIdx vector.
+   */
+  [[nodiscard]] const std::vector<int> &getColIdx() const;
+
+  /**
+   * @brief Returns the value of every non-zero, parallel to getColIdx(), or
+   * an empty vector for a pattern-only (boolean) matrix.
+   *
+   * The value constructor and semiringMatmul() produce values, and
+   * transpose(), multiplyVector() and the Reordering permutations honor
+   * them. Searches and orderings (bfsLevels(), reverseCuthillMcKee(), ...)
+   * only depend on the pattern and accept either kind of matrix. Everything
+   * else works on the sparsity pattern alone and throws
+   * std::invalid_argument rather than drop values silently: the boolean
+   * products, the sparse-vector products, triangle and common-neighbor
+   * counts, and the conversions to the pattern-only formats (SellMatrix,
+   * DCSRMatrix, CompressedCSRMatrix, BasicCSRMatrix, BlockCSRMatrix,
+   * DenseBitMatrix). semiringMatmul<BooleanSemiring>() is the explicit way
+   * to multiply the patterns of valued matrices.
+   *
+   * @return Reference to the internal values vector.
+   */
+  [[nodiscard]] const std::vector<double> &getValues() const;
+
+  /**
+   * @brief Multiplies this matrix by `right` over a semiring policy from
+   * Semiring.h.
+   *
+   * Runs the Gustavson row kernel of naiveMatmul(), or with several threads
+   * the row-wise job of parallelMatmul(), instantiated for the policy.
+   * BooleanSemiring compiles to the value-free kernels unchanged; other
+   * policies add a dense value accumulator to the same loop. The policy's
+   * operations are static and inlined, and whether each operand has values
+   * is decided once per product, so there is no per-element indirection.
+   * Operands without values count each entry as the policy's one().
+   *
+   * @tparam Semiring BooleanSemiring, PlusTimesSemiring, MinPlusSemiring or
+   * MaxTimesSemiring
+   * @param right The right-hand matrix in the multiplication (this × right)
+   * @param numThreads Number of worker threads (1 = sequential, 0 = shared
+   * pool sized to hardware concurrency)
+   * @return CSRMatrix representing the product, with values unless the
+   * semiring is boolean
+   *
+   * @throws std::invalid_argument on matrix dimension mismatch.
+   */
+  template <typename Semiring>
+  [[nodiscard]] CSRMatrix semiringMatmul(const CSRMatrix &right,
+                                         int numThreads = 1) const;
+
   /**
    * @brief Performs naive (without product estimation) sparse matrix
    * multiplication with this matrix on the left.
@@ -59,7 +157,10 @@ public:
    * with this matrix on the left.
    *
    * Multiplies the current matrix (as left operand) with the given matrix
-   * `right`, returning the coordinate list of the result.
+   * `right`, returning the coordinate list of the result. When the estimate
+   * puts the product at 5% density or more, it is computed as a
+   * DenseBitMatrix through multiplyAs(): by Four Russians on bit-packed
+   * operands, or by row scatter when packing them would cost too much.
    *
    * @param right The right-hand matrix in the multiplication (this × right)
    * @return CSRMatrix representing the product
@@ -68,6 +169,103 @@ public:
    */
   CSRMatrix optimizedMatmul(const CSRMatrix &right, double estimate);
 
+  /**
+   * @brief Performs naive sparse matrix multiplication using caller-owned
+   * scratch memory.
+   *
+   * Same result as naiveMatmul(right), but markers and output buffers come
+   * from `workspace` and keep their capacity across calls.
+   *
+   * @param right The right-hand matrix in the multiplication (this × right)
+   * @param workspace Scratch memory, reused through its thread 0 buffers
+   * @return CSRMatrix representing the product
+   *
+   * @throws std::invalid_argument on matrix dimension mismatch.
+   */
+  CSRMatrix naiveMatmul(const CSRMatrix &right,
+                        SpGEMMWorkspace &workspace) const;
+
+  /**
+   * @brief Performs optimized sparse matrix multiplication using
+   * caller-owned scratch memory.
+   *
+   * Same result as optimizedMatmul(right, estimate), but markers and output
+   * buffers come from `workspace` and keep their capacity across calls.
+   * Dense products take the same DenseBitMatrix path and leave the
+   * workspace untouched.
+   *
+   * @param right The right-hand matrix in the multiplication (this × right)
+   * @param estimate The estimated product size of resulting matrix
+   * @param workspace Scratch memory, reused through its thread 0 buffers
+   * @return CSRMatrix representing the product
+   *
+   * @throws std::invalid_argument on matrix dimension mismatch.
+   */
+  CSRMatrix optimizedMatmul(const CSRMatrix &right, double estimate,
+                            SpGEMMWorkspace &workspace);
+
+  /**
+   * @brief Multiplies this matrix by `right`, writing the product into `out`.
+   *
+   * Reuses the existing rowPtr/colIdx storage of `out` and only grows it
+   * when its capacity is short, so recomputing a product of similar size
+   * performs no allocation. `out` may alias either operand.
+   *
+   * @param right The right-hand matrix in the multiplication (this × right)
+   * @param out Matrix overwritten with the product
+   *
+   * @throws std::invalid_argument on matrix dimension mismatch.
+   */
+  void multiplyInto(const CSRMatrix &right, CSRMatrix &out) const;
+
+  /**
+   * @brief Multiplies this matrix by `right` into `out`, taking the row
+   * accumulator from `workspace`.
+   *
+   * @param right The right-hand matrix in the multiplication (this × right)
+   * @param out Matrix overwritten with the product
+   * @param workspace Scratch memory, reused through its thread 0 buffers
+   *
+   * @throws std::invalid_argument on matrix dimension mismatch.
+   */
+  void multiplyInto(const CSRMatrix &right, CSRMatrix &out,
+                    SpGEMMWorkspace &workspace) const;
+
+  /**
+   * @brief Unions the product (this × right) into `accum`, i.e.
+   * accum ∪= this × right.
+   *
+   * Each row of `accum` is preloaded into the row accumulator before the
+   * row of the product is scattered into it, so the union is written out in
+   * a single pass and the product is never materialized. `accum` may alias
+   * either operand.
+   *
+   * @param right The right-hand matrix in the multiplication (this × right)
+   * @param accum Matrix shaped like the product, updated in place
+   *
+   * @throws std::invalid_argument on matrix dimension mismatch or if `accum`
+   * is not shaped like the product.
+   */
+  void multiplyAccumulate(const CSRMatrix &right, CSRMatrix &accum) const;
+
+  /**
+   * @brief Unions the product (this × right) into `accum`, taking the row
+   * accumulator and output buffers from `workspace`.
+   *
+   * The previous storage of `accum` is swapped back into the workspace, so
+   * repeated accumulation alternates between two sets of buffers without
+   * allocating.
+   *
+   * @param right The right-hand matrix in the multiplication (this × right)
+   * @param accum Matrix shaped like the product, updated in place
+   * @param workspace Scratch memory, reused through its thread 0 buffers
+   *
+   * @throws std::invalid_argument on matrix dimension mismatch or if `accum`
+   * is not shaped like the product.
+   */
+  void multiplyAccumulate(const CSRMatrix &right, CSRMatrix &accum,
+                          SpGEMMWorkspace &workspace) const;
+
   /**
    * @brief Performs naive batched sparse matrix multiplication
    * with this matrix on the left.
@@ -75,13 +273,19 @@ public:
    * Multiplies the current matrix (as left operand) with each matrix in
    * 'rights', returning a list of results.
    *
+   * In fused mode the batch is computed as this × [B1 | B2 | … | Bn]: each
+   * row of this matrix and its join keys are walked once against every B_i,
+   * writing straight into per-B_i output segments.
+   *
    * @param rights The right-hand matrices in the multiplication (this × right)
+   * @param fused Whether to compute the whole batch in a single pass
    * @return Vector of CSRMatrix representing the product
    *
    * @throws std::invalid_argument on matrix dimension mismatch.
    */
   [[nodiscard]] std::vector<CSRMatrix>
-  batchNaiveMatmul(const std::vector<CSRMatrix> &rights) const;
+  batchNaiveMatmul(const std::vector<CSRMatrix> &rights,
+                   bool fused = false) const;
 
   /**
    * @brief Performs optimized batched sparse matrix multiplication
@@ -90,15 +294,249 @@ public:
    * Multiplies the current matrix (as left operand) with each matrix in
    * 'rights', returning a list of results.
    *
+   * In fused mode the batch is computed in a single pass over this matrix,
+   * as in batchNaiveMatmul, with each B_i's output presized by its estimate.
+   *
    * @param rights The right-hand matrix in the multiplication (this × right)
    * @param epsilon The estimated product size of resulting matrix
+   * @param fused Whether to compute the whole batch in a single pass
    * @return Vector of CSRMatrix representing the product
    *
    * @throws std::invalid_argument on matrix dimension mismatch.
    */
   [[nodiscard]] std::vector<CSRMatrix>
   batchOptimizedMatmul(const std::vector<CSRMatrix> &rights,
-                       double epsilon = 0.1) const;
+                       double epsilon = 0.1, bool fused = false) const;
+
+  /**
+   * @brief Computes only the entries of (this × right) selected by a mask.
+   *
+   * The mask's row is used as the accumulator, so rows with an empty mask
+   * are skipped and a row stops scanning as soon as every masked column has
+   * been found. With `complement`, the entries outside the mask are kept
+   * instead.
+   *
+   * @param right The right-hand matrix in the multiplication (this × right)
+   * @param mask Pattern of the entries to compute, shaped like the product
+   * @param complement Whether to keep the entries outside the mask instead
+   * @return CSRMatrix holding (this × right) ∩ mask, or (this × right) \ mask
+   *
+   * @throws std::invalid_argument on matrix or mask dimension mismatch.
+   */
+  [[nodiscard]] CSRMatrix maskedMatmul(const CSRMatrix &right,
+                                       const CSRMatrix &mask,
+                                       bool complement = false) const;
+
+  /**
+   * @brief Performs outer-product sparse matrix multiplication with this
+   * matrix on the left.
+   *
+   * Reads this matrix column-wise (CSC) and `right` row-wise (CSR), so each
+   * row of `right` is read exactly once. Partial products of every join key
+   * are routed into row-partitioned buckets, which are then deduplicated and
+   * sorted in parallel.
+   *
+   * @param right The right-hand matrix in the multiplication (this × right)
+   * @param numThreads Number of worker threads (0 = hardware concurrency)
+   * @return CSRMatrix representing the product
+   *
+   * @throws std::invalid_argument on matrix dimension mismatch.
+   */
+  [[nodiscard]] CSRMatrix outerProductMatmul(const CSRMatrix &right,
+                                             int numThreads = 0) const;
+
+  /**
+   * @brief Returns the transpose of this matrix.
+   *
+   * Converts CSR to CSC (equivalently, CSR of the transpose) with a parallel
+   * counting sort over row blocks; no comparison sort is needed and the
+   * output rows come out sorted. Values, if present, move with their
+   * entries.
+   *
+   * @param numThreads Number of worker threads (0 = hardware concurrency)
+   * @return CSRMatrix holding the transpose
+   */
+  [[nodiscard]] CSRMatrix transpose(int numThreads = 0) const;
+
+  /**
+   * @brief Computes this^T × right without materializing the transpose.
+   *
+   * This matrix's CSR arrays are the CSC arrays of its transpose, so the
+   * outer-product kernel walks them directly, one shared row at a time.
+   *
+   * @param right The right-hand matrix, with as many rows as this matrix
+   * @param numThreads Number of worker threads (0 = hardware concurrency)
+   * @return CSRMatrix representing this^T × right
+   *
+   * @throws std::invalid_argument if the row counts differ.
+   */
+  [[nodiscard]] CSRMatrix transposeMatmul(const CSRMatrix &right,
+                                          int numThreads = 0) const;
+
+  /**
+   * @brief Computes this × right^T without going through getCoords().
+   *
+   * Small outputs are computed by intersecting sorted rows of both operands
+   * pairwise. Otherwise right is transposed with the parallel counting sort
+   * and multiplied row-wise with parallelMatmul.
+   *
+   * @param right The right-hand matrix, with as many columns as this matrix
+   * @param numThreads Number of worker threads (0 = hardware concurrency)
+   * @return CSRMatrix representing this × right^T
+   *
+   * @throws std::invalid_argument if the column counts differ.
+   */
+  [[nodiscard]] CSRMatrix matmulTranspose(const CSRMatrix &right,
+                                          int numThreads = 0) const;
+
+  /**
+   * @brief Computes the symmetric product this × this^T, evaluating only its
+   * upper triangle (diagonal included).
+   *
+   * Row i walks, for each of its columns, only the rows j >= i of that
+   * column, which roughly halves the flops and the output. Rows are
+   * processed in work-balanced blocks on a WorkStealingPool.
+   *
+   * @param mirror If true, mirror the triangle into the full product;
+   * otherwise return the upper triangle, which mirrorUpperTriangle() can
+   * expand later
+   * @param numThreads Number of worker threads (0 = shared pool sized to
+   * hardware concurrency)
+   * @return CSRMatrix of shape (rows × rows) holding the upper triangle or
+   * the full product
+   */
+  [[nodiscard]] CSRMatrix symmetricMatmul(bool mirror = false,
+                                          int numThreads = 0) const;
+
+  /**
+   * @brief Expands an upper-triangular matrix into the symmetric matrix it
+   * represents, e.g. the output of symmetricMatmul().
+   *
+   * The matrix must hold no entries below the diagonal. Each full row is the
+   * transpose's row (without its diagonal) followed by the stored row.
+   *
+   * @param numThreads Number of worker threads (0 = hardware concurrency)
+   * @return Full symmetric CSRMatrix
+   *
+   * @throws std::invalid_argument if the matrix is not square.
+   */
+  [[nodiscard]] CSRMatrix mirrorUpperTriangle(int numThreads = 0) const;
+
+  /**
+   * @brief Performs load-balanced parallel row-wise sparse matrix
+   * multiplication with this matrix on the left.
+   *
+   * Computes the flop count of every row (the sum of the lengths of the B rows
+   * it touches) and cuts the rows into chunks of equal work, splitting single
+   * heavy rows across chunks. Chunks are executed on a WorkStealingPool.
+   *
+   * @param right The right-hand matrix in the multiplication (this × right)
+   * @param numThreads Number of worker threads (0 = shared pool sized to
+   * hardware concurrency)
+   * @return CSRMatrix representing the product
+   *
+   * @throws std::invalid_argument on matrix dimension mismatch.
+   */
+  [[nodiscard]] CSRMatrix parallelMatmul(const CSRMatrix &right,
+                                         int numThreads = 0) const;
+
+  /**
+   * @brief Performs parallel batched sparse matrix multiplication with this
+   * matrix on the left.
+   *
+   * Every (batch item × row chunk) pair becomes one task on a shared
+   * WorkStealingPool, with each product's share of chunks proportional to
+   * its flop count, so uneven right-hand matrices balance across cores.
+   *
+   * @param rights The right-hand matrices in the multiplication (this × right)
+   * @param numThreads Number of worker threads (0 = shared pool sized to
+   * hardware concurrency)
+   * @return Vector of CSRMatrix representing the products, in input order
+   *
+   * @throws std::invalid_argument on matrix dimension mismatch.
+   */
+  [[nodiscard]] std::vector<CSRMatrix>
+  batchParallelMatmul(const std::vector<CSRMatrix> &rights,
+                      int numThreads = 0) const;
+
+  /**
+   * @brief Computes the boolean matrix power this^k by repeated squaring.
+   *
+   * Squares and partial products alternate between two matrices, so no
+   * iteration deep-copies its input. Squaring stops early once a square
+   * equals its base, since every further power of that base is itself.
+   *
+   * @param k Non-negative exponent; this^0 is the identity
+   * @param numThreads Number of worker threads; 1 multiplies in place
+   * through a reused workspace, otherwise each product runs on the parallel
+   * row-wise kernel into reused buffers (0 = shared pool sized to hardware
+   * concurrency)
+   * @return CSRMatrix holding this^k
+   *
+   * @throws std::invalid_argument if the matrix is not square or k < 0.
+   */
+  [[nodiscard]] CSRMatrix power(int k, int numThreads = 0) const;
+
+  /**
+   * @brief Computes the transitive closure this ∪ this^2 ∪ this^3 ∪ …
+   *
+   * Repeats R ∪= R × R, which doubles the path length covered per step, until
+   * the number of non-zeros stops growing. R only ever gains entries, so an
+   * unchanged count means an unchanged matrix.
+   *
+   * @param numThreads Number of worker threads; 1 accumulates in place with
+   * multiplyAccumulate, otherwise the parallel row-wise kernel writes
+   * R ∪ R × R into a reused second buffer (0 = shared pool sized to hardware
+   * concurrency)
+   * @return CSRMatrix holding the transitive closure
+   *
+   * @throws std::invalid_argument if the matrix is not square.
+   */
+  [[nodiscard]] CSRMatrix transitiveClosure(int numThreads = 0) const;
+
+  /**
+   * @brief Groups rows with identical column patterns.
+   *
+   * Each row's colIdx range is hashed, and rows whose hashes collide are
+   * compared entry by entry, so equal hashes never merge different rows.
+   *
+   * @return For every row, the index of the first row with the same pattern
+   * (the row itself if no earlier row matches)
+   */
+  [[nodiscard]] std::vector<int> duplicateRowRepresentatives() const;
+
+  /**
+   * @brief Performs boolean sparse matrix multiplication, computing the
+   * product row of each distinct row pattern once.
+   *
+   * Rows are grouped by duplicateRowRepresentatives(); only the first row of
+   * each group is multiplied, and its product row is then copied to every
+   * duplicate. When no two rows are alike this is a plain multiply.
+   *
+   * @param right The right-hand matrix in the multiplication (this × right)
+   * @param numThreads Number of worker threads for the distinct rows; 1 runs
+   * naiveMatmul, otherwise parallelMatmul (0 = shared pool sized to hardware
+   * concurrency)
+   * @return CSRMatrix representing the product
+   *
+   * @throws std::invalid_argument on matrix dimension mismatch.
+   * @throws std::overflow_error if the product has more non-zeros than an
+   * int offset can address.
+   */
+  [[nodiscard]] CSRMatrix dedupRowsMatmul(const CSRMatrix &right,
+                                          int numThreads = 0) const;
+
+  /**
+   * @brief Computes y = this × x for a dense vector, where each y[i] sums x
+   * over row i's columns, weighted by the entries' values if there are any.
+   *
+   * @param x Dense vector with one entry per column
+   * @return Dense vector with one entry per row
+   *
+   * @throws std::invalid_argument if x does not have one entry per column.
+   */
+  [[nodiscard]] std::vector<double>
+  multiplyVector(const std::vector<double> &x) const;
 
   /**
    * @brief Returns the shape (numRows, numCols) of the matrix.
@@ -107,9 +545,98 @@ public:
   [[nodiscard]] std::pair<int, int> shape() const;
 
 private:
-  // Only working with boolean matrices, so no values vector is needed.
+  // Row-wise product of one left/right pair over a semiring policy, split
+  // into pool tasks.
+  template <typename Semiring> class RowWiseJob;
+
+  /**
+   * @brief Single-pass kernel for this × [B1 | B2 | … | Bn].
+   *
+   * @param rights The right-hand matrices, already dimension-checked
+   * @param reserveHints Expected nnz of each product (may be empty)
+   * @return Vector of CSRMatrix representing the products, in input order
+   */
+  [[nodiscard]] std::vector<CSRMatrix>
+  fusedBatchMatmul(const std::vector<CSRMatrix> &rights,
+                   const std::vector<size_t> &reserveHints) const;
+
+  /**
+   * @brief Row-wise parallel product behind parallelMatmul, written into
+   * `out` so its buffers keep their capacity across calls.
+   *
+   * @param right The right-hand matrix, already dimension-checked
+   * @param accum If non-null, unioned into the product (accum ∪ this × right)
+   * @param out Matrix overwritten with the result; must not alias this,
+   * right or accum
+   * @param numThreads Number of worker threads (0 = shared pool sized to
+   * hardware concurrency)
+   */
+  template <typename Semiring = BooleanSemiring>
+  void parallelMultiplyInto(const CSRMatrix &right, const CSRMatrix *accum,
+                            CSRMatrix &out, int numThreads) const;
+
+  // multiplyInto() with an explicit row accumulator.
+  void multiplyInto(const CSRMatrix &right, CSRMatrix &out,
+                    MarkerArray &marker) const;
+
+  // multiplyAccumulate() with an explicit row accumulator and output buffers.
+  void multiplyAccumulate(const CSRMatrix &right, CSRMatrix &accum,
+                          MarkerArray &marker, std::vector<int> &outRowPtr,
+                          std::vector<int> &outColIdx) const;
+
+  /**
+   * @brief Gustavson's row-wise kernel behind naiveMatmul/optimizedMatmul
+   * and semiringMatmul.
+   *
+   * @tparam Semiring Policy from Semiring.h; the boolean default never
+   * touches values
+   * @param right The right-hand matrix, already dimension-checked
+   * @param marker Column markers for deduplicating each output row
+   * @param outRowPtr Output row pointers (cleared first, capacity kept)
+   * @param outColIdx Output column indices (cleared first, capacity kept)
+   * @param outValues Output values for valued semirings (cleared first)
+   */
+  template <typename Semiring = BooleanSemiring>
+  void gustavson(const CSRMatrix &right, MarkerArray &marker,
+                 std::vector<int> &outRowPtr, std::vector<int> &outColIdx,
+                 std::vector<double> *outValues = nullptr) const;
+
+  /**
+   * @brief Builds the CSC (column-major) form of this matrix with a parallel
+   * counting sort. Each worker keeps N column counts, so fewer workers than
+   * requested run when that would exceed the matrix's non-zero count.
+   *
+   * @param colPtr Output column pointers, of size N + 1
+   * @param rowIdx Output row indices, sorted within each column
+   * @param numThreads Number of worker threads (0 = hardware concurrency)
+   * @param cscValues If given, receives the values parallel to rowIdx, or
+   * is emptied for a pattern-only matrix
+   */
+  void toCSC(std::vector<int> &colPtr, std::vector<int> &rowIdx,
+             int numThreads = 0,
+             std::vector<double> *cscValues = nullptr) const;
+
+  /**
+   * @brief Outer-product kernel shared by outerProductMatmul and
+   * batchOptimizedMatmul, with the left operand already in CSC form.
+   *
+   * @param colPtrA Column pointers of the left operand
+   * @param rowIdxA Row indices of the left operand
+   * @param rowsA Number of rows of the left operand
+   * @param right The right-hand matrix in the multiplication
+   * @param numThreads Number of worker threads (0 = hardware concurrency)
+   * @param reserveHint Expected product nnz, used to presize the output
+   * @return CSRMatrix representing the product
+   */
+  static CSRMatrix outerProduct(const std::vector<int> &colPtrA,
+                                const std::vector<int> &rowIdxA, int rowsA,
+                                const CSRMatrix &right, int numThreads,
+                                size_t reserveHint = 0);
+
+  // Boolean matrices leave values empty; it is only filled for semirings.
   std::vector<int> rowPtr;
   std::vector<int> colIdx;
+  std::vector<double> values;
 
   int M, N; // num rows, num cols
 };
@@ -0,0 +1,118 @@
+#ifndef COMPRESSEDCSRMATRIX_H
+#define COMPRESSEDCSRMATRIX_H
+
+#include "CSRMatrix.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class CompressedCSRMatrix
+ * @brief Stores a boolean sparse matrix in CSR form with delta-encoded
+ * column indices.
+ *
+ * Each row's sorted columns are stored as 16-bit gaps from the previous
+ * column (the first from column 0). A gap that does not fit is written as
+ * the escape word 0xFFFF followed by the full column in two words. Clustered
+ * rows therefore take about half the index bytes of CSRMatrix, and the
+ * kernels decode the gaps as they stream over a row instead of expanding it
+ * first.
+ */
+class CompressedCSRMatrix {
+public:
+  /**
+   * @brief Encodes the column indices of a CSRMatrix.
+   *
+   * @param csr The matrix to compress
+   *
+   * @throws std::invalid_argument if csr has values.
+   */
+  explicit CompressedCSRMatrix(const CSRMatrix &csr);
+
+  /**
+   * @brief Decodes back to a plain CSRMatrix.
+   * @return CSRMatrix holding the same entries
+   */
+  [[nodiscard]] CSRMatrix toCSR() const;
+
+  /**
+   * @brief Performs row-wise sparse matrix multiplication (this × right),
+   * decoding both operands' rows inside the multiply loop.
+   *
+   * @param right The right-hand matrix in the multiplication (this × right)
+   * @return CSRMatrix representing the product
+   *
+   * @throws std::invalid_argument on matrix dimension mismatch.
+   */
+  [[nodiscard]] CSRMatrix naiveMatmul(const CompressedCSRMatrix &right) const;
+
+  /**
+   * @brief Computes y = this × x for a dense vector, decoding each row as it
+   * is summed.
+   *
+   * @param x Dense vector with one entry per column
+   * @return Dense vector with one entry per row
+   *
+   * @throws std::invalid_argument if x does not have one entry per column.
+   */
+  [[nodiscard]] std::vector<double>
+  multiplyVector(const std::vector<double> &x) const;
+
+  /**
+   * @brief Multiplies a boolean sparse row vector by this matrix, x × A,
+   * decoding the selected rows as they are scattered.
+   *
+   * Like the CSRMatrix vectorMatmul(), sparse results are deduplicated with
+   * markers and sorted, and dense ones are collected from a bitmap.
+   *
+   * @param x Sorted, distinct indices of the vector's non-zeros
+   * @return Sorted indices of the non-zeros of x × A
+   *
+   * @throws std::out_of_range if an index of x is not a row of the matrix.
+   */
+  [[nodiscard]] std::vector<int> vectorMatmul(const std::vector<int> &x) const;
+
+  /**
+   * @brief Breadth-first search from one source over this matrix as a
+   * directed adjacency, decoding each frontier row as it is expanded.
+   *
+   * Always pushes along out-edges: pulling needs the transpose, which would
+   * cost a full decode. For direction-optimizing search, decode once with
+   * toCSR() and call bfsLevels() on the result.
+   *
+   * @param source Start vertex
+   * @return BFS level of every vertex, or -1 if unreachable
+   *
+   * @throws std::invalid_argument if the matrix is not square.
+   * @throws std::out_of_range if source is not a vertex.
+   */
+  [[nodiscard]] std::vector<int> bfsLevels(int source) const;
+
+  /**
+   * @brief Returns the number of bytes used by the encoded column indices,
+   * for comparison with 4 bytes per non-zero in CSRMatrix.
+   */
+  [[nodiscard]] size_t indexBytes() const;
+
+  /**
+   * @brief Returns the number of non-zero entries.
+   */
+  [[nodiscard]] size_t nnz() const;
+
+  /**
+   * @brief Returns the shape (numRows, numCols) of the matrix.
+   * @return std::pair<int, int> representing (rows, cols)
+   */
+  [[nodiscard]] std::pair<int, int> shape() const;
+
+private:
+  // Calls fn(col) for every column of the row, decoding as it goes.
+  template <typename Fn> void forEachInRow(int row, Fn &&fn) const;
+
+  std::vector<int> rowPtr;     // offsets into gaps, in 16-bit words
+  std::vector<uint16_t> gaps;  // encoded column gaps
+  size_t numNonZeros = 0;
+
+  int M, N; // num rows, num cols
+};
+
+#endif // COMPRESSEDCSRMATRIX_H
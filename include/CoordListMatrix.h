@@ -1,6 +1,7 @@
 #ifndef COORDLISTMATRIX_H
 #define COORDLISTMATRIX_H
 
+#include "SpGEMMWorkspace.h"
 #include "Types.h"
 #include <string>
 #include <vector>
@@ -68,6 +69,41 @@ public:
   CoordListMatrix optimizedMatmul(const CoordListMatrix &right,
                                   double estimation);
 
+  /**
+   * @brief Performs naive sparse matrix multiplication using caller-owned
+   * scratch memory.
+   *
+   * Same product as naiveMatmul(right), but the row-grouped operands and the
+   * row accumulator come from `workspace` instead of per-call vectors of
+   * vectors and sets, and keep their capacity across calls.
+   *
+   * @param right The right-hand matrix in the multiplication (this × right)
+   * @param workspace Scratch memory, reused through its thread 0 buffers
+   * @return CoordListMatrix representing the product, sorted by (row, col)
+   *
+   * @throws std::invalid_argument on matrix dimension mismatch.
+   */
+  CoordListMatrix naiveMatmul(const CoordListMatrix &right,
+                              SpGEMMWorkspace &workspace) const;
+
+  /**
+   * @brief Performs optimized sparse matrix multiplication using
+   * caller-owned scratch memory.
+   *
+   * Same product as optimizedMatmul(right, estimation), with scratch space
+   * taken from `workspace` as in the naive overload.
+   *
+   * @param right The right-hand matrix in the multiplication (this × right)
+   * @param estimation The estimated product size of resulting matrix
+   * @param workspace Scratch memory, reused through its thread 0 buffers
+   * @return CoordListMatrix representing the product, sorted by (row, col)
+   *
+   * @throws std::invalid_argument on matrix dimension mismatch.
+   */
+  CoordListMatrix optimizedMatmul(const CoordListMatrix &right,
+                                  double estimation,
+                                  SpGEMMWorkspace &workspace);
+
   /**
    * @brief Performs naive batched sparse matrix multiplication
    * with this matrix on the left.
@@ -100,6 +136,26 @@ public:
   batchOptimizedMatmul(const std::vector<CoordListMatrix> &rights,
                        double epsilon = 0.1) const;
 
+  /**
+   * @brief Performs parallel batched sparse matrix multiplication with this
+   * matrix on the left.
+   *
+   * Every (batch item × row chunk) pair becomes one task on a shared
+   * WorkStealingPool, with each product's share of chunks proportional to
+   * its flop count, so uneven right-hand matrices balance across cores.
+   *
+   * @param rights The right-hand matrices in the multiplication (this × right)
+   * @param numThreads Number of worker threads (0 = shared pool sized to
+   * hardware concurrency)
+   * @return Vector of CoordListMatrix representing the products, in input
+   * order
+   *
+   * @throws std::invalid_argument on matrix dimension mismatch.
+   */
+  [[nodiscard]] std::vector<CoordListMatrix>
+  batchParallelMatmul(const std::vector<CoordListMatrix> &rights,
+                      int numThreads = 0) const;
+
   /**
    * @brief Returns a vector of non-zero (row, col) coordinates with their
    * respective hash values.
@@ -0,0 +1,103 @@
+#ifndef DCSRMATRIX_H
+#define DCSRMATRIX_H
+
+#include "CSRMatrix.h"
+#include "Types.h"
+#include <vector>
+
+/**
+ * @class DCSRMatrix
+ * @brief Stores a hypersparse matrix in Doubly-Compressed Sparse Row format.
+ *
+ * Only non-empty rows are stored: rowIds lists them in increasing order and
+ * rowPtr has one entry per stored row (plus one), so memory and row loops
+ * scale with the number of non-zeros rather than the number of rows.
+ */
+class DCSRMatrix {
+public:
+  /**
+   * @brief Compresses a CSRMatrix by dropping its empty rows.
+   *
+   * @param csr The matrix to convert
+   *
+   * @throws std::invalid_argument if csr has values.
+   */
+  explicit DCSRMatrix(const CSRMatrix &csr);
+
+  /**
+   * @brief Constructs a DCSRMatrix from a vector of type Coord, without
+   * allocating anything per row of the full matrix.
+   *
+   * @param coords Occupied indices of the matrix; duplicates are merged
+   * @param M Number of rows in matrix
+   * @param N Number of cols in matrix
+   *
+   * @throws std::invalid_argument on invalid M, N.
+   * @throws std::out_of_range if a Coord lies outside the matrix.
+   */
+  DCSRMatrix(const std::vector<Coord> &coords, int M, int N);
+
+  /**
+   * @brief Expands back to CSR, restoring the empty rows.
+   * @return CSRMatrix holding the same entries
+   */
+  [[nodiscard]] CSRMatrix toCSR() const;
+
+  /**
+   * @brief Performs row-wise sparse matrix multiplication (this × right).
+   *
+   * Only the stored rows of this matrix are visited. Each column index of
+   * this matrix is first translated to the matching stored row of right (or
+   * none), so the inner loop reads right's rows directly. Output rows are
+   * accumulated in a marker array when the product's flops cover its column
+   * count, and by sort-and-unique otherwise, keeping memory proportional to
+   * the work.
+   *
+   * @param right The right-hand matrix in the multiplication (this × right)
+   * @return DCSRMatrix representing the product
+   *
+   * @throws std::invalid_argument on matrix dimension mismatch.
+   */
+  [[nodiscard]] DCSRMatrix naiveMatmul(const DCSRMatrix &right) const;
+
+  /**
+   * @brief Returns a vector of non-zero (row, col) coordinates.
+   * @return Vector of Coords listing non-zero indices in the matrix.
+   */
+  [[nodiscard]] std::vector<Coord> getCoords() const;
+
+  /**
+   * @brief Returns the indices of the non-empty rows, in increasing order.
+   * @return Reference to the internal rowIds vector.
+   */
+  [[nodiscard]] const std::vector<int> &getRowIds() const;
+
+  /**
+   * @brief Returns the pointers of the stored rows (size numStoredRows + 1).
+   * @return Reference to the internal rowPtr vector.
+   */
+  [[nodiscard]] const std::vector<int> &getRowPtr() const;
+
+  /**
+   * @brief Returns the column index of every non-zero, sorted within rows.
+   * @return Reference to the internal colIdx vector.
+   */
+  [[nodiscard]] const std::vector<int> &getColIdx() const;
+
+  /**
+   * @brief Returns the shape (numRows, numCols) of the matrix.
+   * @return std::pair<int, int> representing (rows, cols)
+   */
+  [[nodiscard]] std::pair<int, int> shape() const;
+
+private:
+  DCSRMatrix(int M, int N) : M(M), N(N) {}
+
+  std::vector<int> rowIds; // non-empty rows, increasing
+  std::vector<int> rowPtr; // one entry per stored row, plus the end
+  std::vector<int> colIdx;
+
+  int M, N; // num rows, num cols
+};
+
+#endif // DCSRMATRIX_H
@@ -0,0 +1,108 @@
+#ifndef DENSEBITMATRIX_H
+#define DENSEBITMATRIX_H
+
+#include "CSRMatrix.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class DenseBitMatrix
+ * @brief Stores a boolean matrix densely, one bit per entry, with each row
+ * packed into 64-bit words.
+ *
+ * Meant for operands and products dense enough that per-entry sparse
+ * storage loses: a row OR is N / 64 word operations regardless of how many
+ * entries it sets.
+ */
+class DenseBitMatrix {
+public:
+  /**
+   * @brief Constructs an all-zero M × N matrix.
+   *
+   * @param M Number of rows in matrix
+   * @param N Number of cols in matrix
+   *
+   * @throws std::invalid_argument on negative M or N.
+   */
+  DenseBitMatrix(int M, int N);
+
+  /**
+   * @brief Packs the entries of a CSRMatrix into bits.
+   *
+   * @param csr The matrix to convert
+   *
+   * @throws std::invalid_argument if csr has values.
+   */
+  explicit DenseBitMatrix(const CSRMatrix &csr);
+
+  /**
+   * @brief Converts back to CSR by scanning each row's set bits.
+   * @return CSRMatrix holding the same entries
+   *
+   * @throws std::overflow_error if the matrix has 2^31 or more set bits.
+   */
+  [[nodiscard]] CSRMatrix toCSR() const;
+
+  /**
+   * @brief Multiplies by the Method of Four Russians (this × right).
+   *
+   * The columns of this matrix are taken in groups of 8. For each group, a
+   * 256-entry table holds the OR of every subset of the matching 8 rows of
+   * right, so each row of the product ORs in one table row per group.
+   *
+   * @param right The right-hand matrix in the multiplication (this × right)
+   * @return DenseBitMatrix representing the product
+   *
+   * @throws std::invalid_argument on matrix dimension mismatch.
+   */
+  [[nodiscard]] DenseBitMatrix naiveMatmul(const DenseBitMatrix &right) const;
+
+  /**
+   * @brief Computes the product of two sparse matrices straight into row
+   * bitmaps.
+   *
+   * Gustavson's row-wise loop, except each entry of a B row sets its bit in
+   * the output row instead of going through markers and a sort.
+   *
+   * @param left The left-hand matrix in the multiplication
+   * @param right The right-hand matrix in the multiplication
+   * @return DenseBitMatrix representing left × right
+   *
+   * @throws std::invalid_argument on matrix dimension mismatch, or if an
+   * operand has values.
+   */
+  static DenseBitMatrix scatterProduct(const CSRMatrix &left,
+                                       const CSRMatrix &right);
+
+  /**
+   * @brief Returns whether entry (row, col) is set.
+   *
+   * @throws std::out_of_range if (row, col) is outside the matrix.
+   */
+  [[nodiscard]] bool get(int row, int col) const;
+
+  /**
+   * @brief Sets entry (row, col).
+   *
+   * @throws std::out_of_range if (row, col) is outside the matrix.
+   */
+  void set(int row, int col);
+
+  /**
+   * @brief Returns the number of non-zero entries, counted by popcount.
+   */
+  [[nodiscard]] size_t nnz() const;
+
+  /**
+   * @brief Returns the shape (numRows, numCols) of the matrix.
+   * @return std::pair<int, int> representing (rows, cols)
+   */
+  [[nodiscard]] std::pair<int, int> shape() const;
+
+private:
+  std::vector<uint64_t> words; // row-major, wordsPerRow words per row
+  int M, N;                    // num rows, num cols
+  int wordsPerRow;
+};
+
+#endif // DENSEBITMATRIX_H
@@ -0,0 +1,76 @@
+#ifndef GRAPHTRAVERSAL_H
+#define GRAPHTRAVERSAL_H
+
+#include "CSRMatrix.h"
+#include <vector>
+
+/**
+ * @brief Multiplies a boolean sparse row vector by a matrix, x × A.
+ *
+ * The vector's rows of A are scattered into the result (push). Sparse
+ * results are deduplicated with markers and sorted; results denser than a
+ * bitmap sweep are collected from a bitmap instead.
+ *
+ * @param x Sorted, distinct indices of the vector's non-zeros
+ * @param matrix Matrix with one row per vector entry
+ * @return Sorted indices of the non-zeros of x × A
+ *
+ * @throws std::invalid_argument if the matrix has values.
+ * @throws std::out_of_range if an index of x is not a row of the matrix.
+ */
+std::vector<int> vectorMatmul(const std::vector<int> &x,
+                              const CSRMatrix &matrix);
+
+/**
+ * @brief Multiplies a matrix by a boolean sparse column vector, A × x.
+ *
+ * x is loaded into a bitmap and each row of A is scanned until its first
+ * hit (pull), so no transpose is needed.
+ *
+ * @param matrix Matrix with one column per vector entry
+ * @param x Sorted, distinct indices of the vector's non-zeros
+ * @return Sorted indices of the non-zeros of A × x
+ *
+ * @throws std::invalid_argument if the matrix has values.
+ * @throws std::out_of_range if an index of x is not a column of the matrix.
+ */
+std::vector<int> matrixVectorMatmul(const CSRMatrix &matrix,
+                                    const std::vector<int> &x);
+
+/**
+ * @brief Breadth-first search from one source over a directed adjacency
+ * matrix, where row u lists the out-neighbors of u.
+ *
+ * Direction-optimizing: small frontiers push along out-edges, and once the
+ * frontier's out-edges outweigh the edges left unexplored, unvisited
+ * vertices pull from their in-neighbors instead (the transpose is built on
+ * first use). Visited vertices are tracked in a bitmap.
+ *
+ * @param adjacency Square adjacency matrix
+ * @param source Start vertex
+ * @return BFS level of every vertex, or -1 if unreachable
+ *
+ * @throws std::invalid_argument if adjacency is not square.
+ * @throws std::out_of_range if source is not a vertex.
+ */
+std::vector<int> bfsLevels(const CSRMatrix &adjacency, int source);
+
+/**
+ * @brief Breadth-first search from many sources, 64 at a time.
+ *
+ * Each vertex holds one 64-bit word of frontier and visited bits, one bit
+ * per source of the batch, so a single sweep over the graph advances all
+ * 64 searches.
+ *
+ * @param adjacency Square adjacency matrix
+ * @param sources Start vertices, one search each
+ * @return BFS levels of every vertex for each source, in input order
+ *
+ * @throws std::invalid_argument if adjacency is not square.
+ * @throws std::out_of_range if a source is not a vertex.
+ */
+std::vector<std::vector<int>>
+multiSourceBfsLevels(const CSRMatrix &adjacency,
+                     const std::vector<int> &sources);
+
+#endif // GRAPHTRAVERSAL_H
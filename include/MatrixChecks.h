@@ -0,0 +1,64 @@
+#ifndef MATRIXCHECKS_H
+#define MATRIXCHECKS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+class CSRMatrix;
+
+/**
+ * @brief Narrows a non-zero count to a row offset, for every sparse format
+ * that builds its row pointers by appending entries.
+ *
+ * int offsets cap a matrix at 2^31 - 1 entries; larger ones need a wider
+ * Offset, e.g. a WideCSRMatrix.
+ *
+ * @tparam Offset Integer type of the row offsets
+ * @param count Number of entries stored so far
+ * @return count as an Offset
+ *
+ * @throws std::overflow_error if count does not fit Offset.
+ */
+template <typename Offset = int> inline Offset toOffset(size_t count) {
+  if (count > static_cast<uint64_t>(std::numeric_limits<Offset>::max())) {
+    throw std::overflow_error(std::to_string(count) +
+                              " non-zeros do not fit the row offset type.");
+  }
+  return static_cast<Offset>(count);
+}
+
+/**
+ * @brief Throws unless the product left × right is defined.
+ *
+ * @param left Shape (rows, cols) of the left-hand matrix
+ * @param right Shape (rows, cols) of the right-hand matrix
+ *
+ * @throws std::invalid_argument on matrix dimension mismatch.
+ */
+inline void requireMatmulShapes(std::pair<int, int> left,
+                                std::pair<int, int> right) {
+  if (left.second != right.first) {
+    throw std::invalid_argument("matmul dimension mismatch: "
+                                "Left cols (" +
+                                std::to_string(left.second) +
+                                ") != Right rows (" +
+                                std::to_string(right.first) + ")");
+  }
+}
+
+/**
+ * @brief Throws if an operand of a pattern-only (boolean) kernel carries
+ * values, which the kernel would otherwise drop silently.
+ *
+ * @param name Kernel named in the error message
+ * @param A Operand to check
+ *
+ * @throws std::invalid_argument if A has values.
+ */
+void requirePattern(const char *name, const CSRMatrix &A);
+
+#endif // MATRIXCHECKS_H
@@ -0,0 +1,195 @@
+#ifndef PRODUCTPLANNER_H
+#define PRODUCTPLANNER_H
+
+#include "CSRMatrix.h"
+#include "DCSRMatrix.h"
+#include "DenseBitMatrix.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <variant>
+#include <vector>
+
+/**
+ * @brief Representation chosen for a product before it is computed.
+ */
+enum class ProductFormat {
+  CSR,         // CSRMatrix, written by Gustavson's row-wise kernel
+  Hypersparse, // DCSRMatrix, when fewer entries are expected than rows
+  BitmapRows,  // DenseBitMatrix, each product row scattered into its bitmap
+  Dense        // DenseBitMatrix, from bit-packed operands by Four Russians
+};
+
+/**
+ * @brief A product in whichever representation was chosen for it.
+ */
+using ProductMatrix = std::variant<CSRMatrix, DCSRMatrix, DenseBitMatrix>;
+
+/**
+ * @brief Picks the product representation from its estimated density.
+ *
+ * A row bitmap costs cols / 8 bytes against 4 bytes per CSR entry, so from
+ * 1/32 density rows are kept as bitmaps. From 5% density the operands are
+ * bit-packed as well and multiplied densely. Both densities are defaults of
+ * kernelThresholds(), which a tuning file may override. Below them, fewer
+ * estimated entries than rows means rowPtr would outweigh colIdx, so the
+ * product is hypersparse.
+ *
+ * @param estimate Estimated number of non-zeros in the product, e.g. from
+ * estimateProductSize
+ * @param rows Number of rows in the product
+ * @param cols Number of cols in the product
+ * @return The representation to compute the product in
+ */
+ProductFormat chooseProductFormat(double estimate, int rows, int cols);
+
+/**
+ * @brief Returns a short name of the format, for logs.
+ */
+const char *toString(ProductFormat format);
+
+/**
+ * @brief Computes left × right directly in the given representation, with
+ * the kernel that writes it natively.
+ *
+ * Dense products bit-pack both operands for the Four Russians kernel unless
+ * packing would take several times their CSR memory, as with a long inner
+ * dimension; they are then scattered row by row into the bitmap instead.
+ *
+ * @param left The left-hand matrix in the multiplication
+ * @param right The right-hand matrix in the multiplication
+ * @param format Representation of the product
+ * @return The product, holding the alternative that matches format
+ *
+ * @throws std::invalid_argument on matrix dimension mismatch, or if an
+ * operand has values.
+ */
+ProductMatrix multiplyAs(const CSRMatrix &left, const CSRMatrix &right,
+                         ProductFormat format);
+
+/**
+ * @brief Computes left × right in the representation its estimated size
+ * calls for, via chooseProductFormat() and multiplyAs().
+ *
+ * @param left The left-hand matrix in the multiplication
+ * @param right The right-hand matrix in the multiplication
+ * @param estimate Estimated number of non-zeros in the product
+ * @return The product in its chosen representation
+ *
+ * @throws std::invalid_argument on matrix dimension mismatch, or if an
+ * operand has values.
+ */
+ProductMatrix multiplyToEstimatedFormat(const CSRMatrix &left,
+                                        const CSRMatrix &right,
+                                        double estimate);
+
+/**
+ * @brief Converts a product in any representation to CSR.
+ */
+CSRMatrix toCSR(const ProductMatrix &product);
+
+/**
+ * @brief Kernel used by multiply().
+ */
+enum class Kernel {
+  Auto,            // decided by planProduct() from ProductStats
+  Gustavson,       // sequential row-wise, CSR output
+  ParallelRowWise, // CSRMatrix::parallelMatmul, CSR output
+  OuterProduct,    // CSRMatrix::outerProductMatmul, CSR output
+  Hypersparse,     // DCSRMatrix::naiveMatmul, DCSR output
+  BitmapRows,      // DenseBitMatrix::scatterProduct, bitmap output
+  Dense            // DenseBitMatrix Four Russians, bitmap output
+};
+
+/**
+ * @brief Kernel and thread count for one product.
+ */
+struct Plan {
+  Kernel kernel = Kernel::Auto;
+  // Threads for the parallel CSR kernels; 0 = one per
+  // kernelThresholds().flopsPerThread flops, up to hardware concurrency.
+  // Other kernels are sequential and run with 1.
+  int numThreads = 0;
+};
+
+/**
+ * @brief Cheap statistics that planProduct() decides from.
+ */
+struct ProductStats {
+  int rows = 0, inner = 0, cols = 0;
+  int64_t nnzA = 0, nnzB = 0;
+  int64_t flops = 0;       // B entries visited by Gustavson's loop
+  int64_t maxRowFlops = 0; // flops of the heaviest row of A
+  double estimatedNnz = 0; // estimateProductSize of the product
+  double compressionRatio = 0; // flops / estimatedNnz
+  // rowLengthHistogram[b] counts rows of A with length in [2^b - 1, 2^(b+1) - 1)
+  std::vector<int> rowLengthHistogram;
+};
+
+/**
+ * @brief Gathers ProductStats for left × right in one pass over A plus one
+ * run of the estimator.
+ *
+ * @param left The left-hand matrix in the multiplication
+ * @param right The right-hand matrix in the multiplication
+ * @param epsilon Error bound passed to estimateProductSize
+ * @return Statistics of the product
+ *
+ * @throws std::invalid_argument on matrix dimension mismatch.
+ */
+ProductStats gatherProductStats(const CSRMatrix &left, const CSRMatrix &right,
+                                double epsilon = 0.1);
+
+/**
+ * @brief Resolves a kernel and thread count from product statistics.
+ *
+ * Non-CSR formats from chooseProductFormat() take their native kernels.
+ * CSR products with too few flops to split stay sequential; otherwise they
+ * get one thread per kernelThresholds().flopsPerThread flops, up to hardware
+ * concurrency. Parallel products that barely compress (flops at most
+ * outerProductCompression times the output) expand and sort with the
+ * outer-product kernel, and the rest run row-wise.
+ *
+ * @param stats Statistics from gatherProductStats()
+ * @param numThreads Thread count to plan CSR products for instead of the
+ * flop rule (0 = derive it); 1 selects Gustavson
+ * @return A plan with no Auto fields left
+ */
+Plan planProduct(const ProductStats &stats, int numThreads = 0);
+
+/**
+ * @brief Returns a short name of the kernel, for logs.
+ */
+const char *toString(Kernel kernel);
+
+/**
+ * @brief Replaces the sink for multiply()'s plan log lines. No sink is set
+ * by default, and an empty function removes it again. Safe to call while
+ * multiplies run; each multiply() uses the sink set when it started.
+ *
+ * @param logger Called with one line per multiply(), possibly from several
+ * threads at once
+ */
+void setPlanLogger(std::function<void(const std::string &)> logger);
+
+/**
+ * @brief Multiplies left × right with a planned kernel.
+ *
+ * With an Auto kernel, statistics are gathered and planProduct() picks the
+ * kernel, and the thread count unless the plan gives one. An explicit kernel
+ * runs as given, with a thread count of 0 resolved by the same flop rule. Either way,
+ * if a sink is set with setPlanLogger(), one line describing the plan and
+ * the statistics behind it is logged.
+ *
+ * @param left The left-hand matrix in the multiplication
+ * @param right The right-hand matrix in the multiplication
+ * @param plan Kernel and thread count, or Auto
+ * @return The product, in the representation its kernel writes
+ *
+ * @throws std::invalid_argument on matrix dimension mismatch, or if an
+ * operand has values.
+ */
+ProductMatrix multiply(const CSRMatrix &left, const CSRMatrix &right,
+                       Plan plan = Plan{});
+
+#endif // PRODUCTPLANNER_H
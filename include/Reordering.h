@@ -0,0 +1,125 @@
+#ifndef REORDERING_H
+#define REORDERING_H
+
+#include "CSRMatrix.h"
+#include <vector>
+
+/*
+ * Every permutation here lists old indices in their new order:
+ * perm[newIndex] = oldIndex.
+ */
+
+/**
+ * @brief Orders the vertices of a square matrix by Reverse Cuthill-McKee,
+ * which keeps neighbors at nearby indices and so narrows the bandwidth.
+ *
+ * The pattern is symmetrized (A ∪ A^T) and self loops are ignored. Each
+ * connected component is traversed breadth-first from a pseudo-peripheral
+ * vertex, visiting neighbors by increasing degree; the final order is the
+ * reversed traversal.
+ *
+ * @param A Square matrix
+ * @return The RCM permutation
+ *
+ * @throws std::invalid_argument if A is not square.
+ */
+std::vector<int> reverseCuthillMcKee(const CSRMatrix &A);
+
+/**
+ * @brief Orders the rows of a matrix by decreasing number of non-zeros, ties
+ * in original order, so hub rows and their heavily reused B rows are
+ * processed together.
+ *
+ * @param A Any matrix
+ * @return The degree-sorted row permutation
+ */
+std::vector<int> degreeOrder(const CSRMatrix &A);
+
+/**
+ * @brief Orders the vertices of a square matrix so each cluster found by
+ * label propagation is contiguous.
+ *
+ * Every vertex starts in its own cluster and repeatedly adopts the most
+ * common cluster among its neighbors in the symmetrized pattern (ties to the
+ * smallest label), until no vertex moves or the round limit is reached.
+ * Clusters are laid out by their first vertex, vertices within a cluster in
+ * original order.
+ *
+ * @param A Square matrix
+ * @param maxRounds Upper bound on propagation rounds
+ * @return The clustered permutation
+ *
+ * @throws std::invalid_argument if A is not square.
+ */
+std::vector<int> clusterOrder(const CSRMatrix &A, int maxRounds = 10);
+
+/**
+ * @brief Inverts a permutation, so inverse[oldIndex] = newIndex.
+ *
+ * @param perm A permutation of [0, perm.size())
+ * @return The inverse permutation
+ *
+ * @throws std::invalid_argument if perm is not a permutation.
+ */
+std::vector<int> invertPermutation(const std::vector<int> &perm);
+
+/**
+ * @brief Returns P_r A P_c^T: row i of the result is row rowPerm[i] of A,
+ * with column j relabelled to the new index of j under colPerm. Values, if
+ * present, move with their entries. Rows are filled in parallel.
+ *
+ * @param A Matrix to permute
+ * @param rowPerm Row permutation, with A's row count entries
+ * @param colPerm Column permutation, with A's column count entries, or
+ * empty to keep the columns
+ * @param numThreads Number of worker threads (0 = shared pool sized to
+ * hardware concurrency)
+ * @return The permuted matrix
+ *
+ * @throws std::invalid_argument if a permutation has the wrong size or is
+ * not a permutation.
+ */
+CSRMatrix permute(const CSRMatrix &A, const std::vector<int> &rowPerm,
+                  const std::vector<int> &colPerm, int numThreads = 0);
+
+/**
+ * @brief Returns P A P^T, relabelling rows and columns of a square matrix
+ * alike.
+ *
+ * @param A Square matrix
+ * @param perm Permutation with A's row count entries
+ * @param numThreads Number of worker threads (0 = shared pool sized to
+ * hardware concurrency)
+ * @return The symmetrically permuted matrix
+ *
+ * @throws std::invalid_argument if A is not square or perm is not a
+ * permutation of its rows.
+ */
+CSRMatrix permuteSymmetric(const CSRMatrix &A, const std::vector<int> &perm,
+                           int numThreads = 0);
+
+/**
+ * @brief Multiplies left × right with left's rows reordered by perm.
+ *
+ * Rows of left are processed in perm order. When left is square, perm also
+ * relabels the inner dimension, i.e. left's columns and right's rows, so
+ * the B rows that neighbouring A rows touch sit close together. The product
+ * is permuted back unless restoreOrder is false, in which case its row i is
+ * row perm[i] of left × right.
+ *
+ * @param left The left-hand matrix in the multiplication
+ * @param right The right-hand matrix in the multiplication
+ * @param perm Permutation of left's rows, e.g. from reverseCuthillMcKee
+ * @param numThreads Number of worker threads (1 = sequential Gustavson,
+ * 0 = shared pool sized to hardware concurrency)
+ * @param restoreOrder Whether to undo perm on the product's rows
+ * @return The product
+ *
+ * @throws std::invalid_argument on matrix dimension mismatch or if perm is
+ * not a permutation of left's rows.
+ */
+CSRMatrix reorderedMatmul(const CSRMatrix &left, const CSRMatrix &right,
+                          const std::vector<int> &perm, int numThreads = 0,
+                          bool restoreOrder = true);
+
+#endif // REORDERING_H
@@ -0,0 +1,119 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief A unit of row-wise multiply work: the left operand's rows
+ * [rowBegin, rowEnd), restricted to its non-zero positions [aBegin, aEnd).
+ *
+ * A chunk either covers whole rows, or is one piece of a single heavy row
+ * (partialRow), whose pieces must be unioned after they are computed.
+ */
+struct RowChunk {
+  int rowBegin, rowEnd;
+  int aBegin, aEnd;
+  bool partialRow;
+};
+
+/**
+ * @brief Cuts the rows of a CSR matrix into chunks of roughly equal work.
+ *
+ * Consecutive rows are packed together until a chunk reaches the per-chunk
+ * work target. A single row heavier than the target is split across several
+ * chunks along its non-zero positions, unless splitHeavyRows is false.
+ *
+ * @param rowPtr Row pointers of the CSR matrix being partitioned
+ * @param nnzWork Work of each non-zero (e.g. length of the B row it selects)
+ * @param numChunks Desired number of chunks
+ * @param splitHeavyRows Whether a single row may be split across chunks
+ * @return Chunks in row order, covering every non-zero exactly once
+ *
+ * @throws std::invalid_argument if nnzWork does not match rowPtr.
+ */
+std::vector<RowChunk> partitionRowsByWork(const std::vector<int> &rowPtr,
+                                          const std::vector<int64_t> &nnzWork,
+                                          int numChunks,
+                                          bool splitHeavyRows = true);
+
+/**
+ * @brief Divides a budget of chunks among several jobs in proportion to their
+ * work, giving every job at least one chunk.
+ *
+ * @param jobWork Total work of each job
+ * @param totalChunks Number of chunks to hand out across all jobs
+ * @return Number of chunks for each job
+ */
+std::vector<int> allocateChunks(const std::vector<int64_t> &jobWork,
+                                int totalChunks);
+
+/**
+ * @class WorkStealingPool
+ * @brief Fixed-size thread pool where every worker owns a task deque.
+ *
+ * Workers pop their own deque from the back and, once it is empty, steal from
+ * the front of the others. The thread calling runAll() also executes tasks
+ * until its batch completes, so a pool of size n runs n tasks at once with
+ * n - 1 background workers.
+ */
+class WorkStealingPool {
+public:
+  /**
+   * @brief Starts the pool's background workers.
+   * @param numThreads Number of threads running tasks, including the caller
+   * of runAll() (0 = hardware concurrency)
+   */
+  explicit WorkStealingPool(int numThreads = 0);
+
+  ~WorkStealingPool();
+
+  WorkStealingPool(const WorkStealingPool &) = delete;
+  WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+  /**
+   * @brief Runs every task in `tasks` and blocks until all have finished.
+   *
+   * Tasks are dealt round-robin over the worker deques and balanced by
+   * stealing. May be called concurrently, including from inside a task.
+   *
+   * @param tasks Tasks to run; order of execution is unspecified
+   * @throws Rethrows the first exception raised by a task.
+   */
+  void runAll(std::vector<std::function<void()>> &tasks);
+
+  /**
+   * @brief Returns the number of threads running tasks, including the caller.
+   */
+  [[nodiscard]] int size() const;
+
+  /**
+   * @brief Returns the process-wide pool sized to hardware concurrency.
+   */
+  static WorkStealingPool &shared();
+
+private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  bool tryRun(int self);
+  void workerLoop(int self);
+
+  std::vector<std::unique_ptr<Queue>> queues;
+  std::vector<std::thread> workers;
+
+  std::mutex sleepMutex;
+  std::condition_variable wake;
+  int64_t pending = 0; // queued tasks not yet taken, guarded by sleepMutex
+  bool stopping = false;
+};
+
+#endif // SCHEDULER_H
@@ -0,0 +1,69 @@
+#ifndef SELLMATRIX_H
+#define SELLMATRIX_H
+
+#include "CSRMatrix.h"
+#include <vector>
+
+/**
+ * @class SellMatrix
+ * @brief Stores a boolean sparse matrix in Sliced ELLPACK (SELL-C-σ) format
+ * for SIMD sparse matrix × dense vector products.
+ *
+ * Rows are grouped into chunks of C. Within each window of σ rows, rows are
+ * sorted by decreasing length so that chunks hold rows of similar length.
+ * Each chunk is padded to its longest row and stored column-major, so one
+ * SIMD lane processes one row and all lanes advance together.
+ */
+class SellMatrix {
+public:
+  /**
+   * @brief Converts a CSR matrix to SELL-C-σ.
+   *
+   * @param csr The matrix to convert
+   * @param chunkSize Rows per chunk (C); multiples of the SIMD width
+   * vectorize best
+   * @param sortWindow Rows per sorting window (σ); must be a multiple of C
+   *
+   * @throws std::invalid_argument if chunkSize or sortWindow is not
+   * positive, sortWindow is not a multiple of chunkSize, or csr has values.
+   */
+  explicit SellMatrix(const CSRMatrix &csr, int chunkSize = 8,
+                      int sortWindow = 256);
+
+  /**
+   * @brief Computes y = A × x, where each y[i] sums x over row i's columns.
+   *
+   * Uses AVX-512 or AVX2 masked gathers when the CPU supports them, chosen
+   * at runtime on x86 GCC/Clang builds whatever the -m flags, and a scalar
+   * loop over the same layout otherwise.
+   *
+   * @param x Dense vector with one entry per column
+   * @return Dense vector with one entry per row
+   *
+   * @throws std::invalid_argument if x does not have one entry per column.
+   */
+  [[nodiscard]] std::vector<double>
+  multiplyVector(const std::vector<double> &x) const;
+
+  /**
+   * @brief Returns the number of stored slots, padding included. Dividing
+   * by the non-zero count gives the padding overhead of the chosen C and σ.
+   */
+  [[nodiscard]] size_t storedSlots() const;
+
+  /**
+   * @brief Returns the shape (numRows, numCols) of the matrix.
+   * @return std::pair<int, int> representing (rows, cols)
+   */
+  [[nodiscard]] std::pair<int, int> shape() const;
+
+private:
+  std::vector<int> chunkPtr; // first slot of each chunk, plus the end
+  std::vector<int> rowLen;   // length of each sorted row, 0 for padding rows
+  std::vector<int> rowPerm;  // original index of each sorted row, -1 if none
+  std::vector<int> colIdx;   // column-major within a chunk, padded with 0
+  int M, N;
+  int C;
+};
+
+#endif // SELLMATRIX_H
@@ -0,0 +1,48 @@
+#ifndef SEMIRING_H
+#define SEMIRING_H
+
+#include <algorithm>
+#include <limits>
+
+/**
+ * @brief Semiring policies for CSRMatrix::semiringMatmul.
+ *
+ * A policy provides zero() and one() as well as add() and multiply(), as
+ * static functions on double, and sets hasValues. Policies without values
+ * (BooleanSemiring) run the value-free boolean kernels unchanged. An operand
+ * without a values array counts every stored entry as one().
+ */
+
+// OR-AND on the sparsity pattern alone: the existing boolean product.
+struct BooleanSemiring {
+  static constexpr bool hasValues = false;
+};
+
+// Ordinary arithmetic, e.g. counting paths between vertices.
+struct PlusTimesSemiring {
+  static constexpr bool hasValues = true;
+  static double zero() { return 0.0; }
+  static double one() { return 1.0; }
+  static double add(double a, double b) { return a + b; }
+  static double multiply(double a, double b) { return a * b; }
+};
+
+// Tropical (min, +), e.g. shortest path lengths.
+struct MinPlusSemiring {
+  static constexpr bool hasValues = true;
+  static double zero() { return std::numeric_limits<double>::infinity(); }
+  static double one() { return 0.0; }
+  static double add(double a, double b) { return std::min(a, b); }
+  static double multiply(double a, double b) { return a + b; }
+};
+
+// (max, ×) on non-negative values, e.g. most reliable paths.
+struct MaxTimesSemiring {
+  static constexpr bool hasValues = true;
+  static double zero() { return 0.0; }
+  static double one() { return 1.0; }
+  static double add(double a, double b) { return std::max(a, b); }
+  static double multiply(double a, double b) { return a * b; }
+};
+
+#endif // SEMIRING_H
@@ -0,0 +1,35 @@
+#ifndef SETINTERSECTION_H
+#define SETINTERSECTION_H
+
+/**
+ * @brief Intersects two strictly increasing integer ranges, such as the
+ * column indices of two CSR rows.
+ *
+ * Compares 4×4 blocks with SSE2 when available and falls back to a scalar
+ * merge otherwise. When one range is much shorter than the other, each of its
+ * elements is located in the longer range by galloping search instead.
+ *
+ * @param a First sorted range
+ * @param na Length of a
+ * @param b Second sorted range
+ * @param nb Length of b
+ * @param out If non-null, receives the common elements in increasing order;
+ * must have room for min(na, nb) values
+ * @return Number of common elements
+ */
+int intersectSorted(const int *a, int na, const int *b, int nb,
+                    int *out = nullptr);
+
+/**
+ * @brief Returns whether two strictly increasing integer ranges share at
+ * least one element, stopping at the first match.
+ *
+ * @param a First sorted range
+ * @param na Length of a
+ * @param b Second sorted range
+ * @param nb Length of b
+ * @return True if the ranges intersect
+ */
+bool intersectsSorted(const int *a, int na, const int *b, int nb);
+
+#endif // SETINTERSECTION_H
@@ -0,0 +1,90 @@
+#ifndef SPGEMMWORKSPACE_H
+#define SPGEMMWORKSPACE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Column markers for sparse accumulation of one output row at a time.
+ *
+ * Each row takes a fresh stamp from next(); column k is already in the row
+ * iff stamp[k] == current. The array therefore never needs clearing between
+ * rows or calls.
+ */
+struct MarkerArray {
+  std::vector<uint32_t> stamp;
+  uint32_t current = 0;
+
+  /**
+   * @brief Grows the markers to cover at least numCols columns.
+   */
+  void ensureSize(int numCols);
+
+  /**
+   * @brief Starts a new row and returns its stamp.
+   */
+  uint32_t next();
+};
+
+/**
+ * @class SpGEMMWorkspace
+ * @brief Reusable scratch memory for the multiply kernels.
+ *
+ * Holds one set of accumulators and temporary buffers per thread. Buffers are
+ * cleared but never shrunk, so passing the same workspace to repeated
+ * multiplies removes steady-state allocation of scratch space.
+ */
+class SpGEMMWorkspace {
+public:
+  /**
+   * @brief Scratch buffers owned by a single thread.
+   */
+  struct ThreadScratch {
+    MarkerArray marker;
+
+    // Output under construction, copied out at its exact size
+    std::vector<int> rowPtr;
+    std::vector<int> colIdx;
+
+    // Row-grouped operands for kernels whose inputs are coordinate lists
+    std::vector<int> leftRowPtr, leftCols;
+    std::vector<int> rightRowPtr, rightCols;
+  };
+
+  /**
+   * @brief Creates a workspace with scratch buffers for numThreads threads.
+   * @throws std::invalid_argument if numThreads is not positive.
+   */
+  explicit SpGEMMWorkspace(int numThreads = 1);
+
+  /**
+   * @brief Returns the scratch buffers of the given thread.
+   * @throws std::out_of_range if thread is not in [0, numThreads()).
+   */
+  ThreadScratch &scratch(int thread = 0);
+
+  /**
+   * @brief Returns the number of per-thread scratch sets.
+   */
+  [[nodiscard]] int numThreads() const;
+
+  /**
+   * @brief Pre-grows every thread's markers and output buffers.
+   *
+   * @param numCols Widest right operand expected
+   * @param numRows Tallest left operand expected
+   * @param nnz Largest product (per thread) expected
+   */
+  void reserve(int numCols, int numRows, size_t nnz);
+
+  /**
+   * @brief Frees all memory held by the workspace.
+   */
+  void release();
+
+private:
+  std::vector<ThreadScratch> threads;
+};
+
+#endif // SPGEMMWORKSPACE_H
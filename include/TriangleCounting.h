@@ -0,0 +1,55 @@
+#ifndef TRIANGLECOUNTING_H
+#define TRIANGLECOUNTING_H
+
+#include "CSRMatrix.h"
+#include "Types.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Result of triangle counting on an undirected graph.
+ */
+struct TriangleCounts {
+  int64_t total = 0;              // number of distinct triangles
+  std::vector<int64_t> perVertex; // number of triangles each vertex is in
+};
+
+/**
+ * @brief Counts triangles in the undirected graph underlying a boolean
+ * adjacency matrix, without materializing A × A.
+ *
+ * Edges are oriented from lower to higher (degree, id) rank, so every
+ * triangle is found exactly once, by intersecting the sorted out-neighbor
+ * lists of an edge's endpoints. Self loops and edge direction are ignored.
+ * Vertices are processed in work-balanced chunks on a WorkStealingPool.
+ *
+ * @param adjacency Square adjacency matrix
+ * @param numThreads Number of worker threads (0 = shared pool sized to
+ * hardware concurrency)
+ * @return Global and per-vertex triangle counts
+ *
+ * @throws std::invalid_argument if adjacency is not square or has values.
+ */
+TriangleCounts countTriangles(const CSRMatrix &adjacency, int numThreads = 0);
+
+/**
+ * @brief Counts the common neighbors of each (u, v) pair, i.e. the
+ * (u, v) entries of A × A^T, without materializing the product.
+ *
+ * Each count is the size of the intersection of rows u and v. For a
+ * symmetric adjacency matrix this equals the (u, v) entry of A × A.
+ *
+ * @param adjacency Adjacency matrix whose rows are neighbor sets
+ * @param pairs Vertex pairs, as (row = u, col = v)
+ * @param numThreads Number of worker threads (0 = shared pool sized to
+ * hardware concurrency)
+ * @return Common-neighbor count of every pair, in input order
+ *
+ * @throws std::invalid_argument if adjacency has values.
+ * @throws std::out_of_range if a pair refers to a row outside the matrix.
+ */
+std::vector<int> countCommonNeighbors(const CSRMatrix &adjacency,
+                                      const std::vector<Coord> &pairs,
+                                      int numThreads = 0);
+
+#endif // TRIANGLECOUNTING_H
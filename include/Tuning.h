@@ -0,0 +1,80 @@
+#ifndef TUNING_H
+#define TUNING_H
+
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Machine-dependent thresholds the multiply kernels decide with.
+ *
+ * The defaults suit a typical desktop; MatmulTune measures replacements for
+ * the machine it runs on and saves them to a tuning file.
+ */
+struct KernelThresholds {
+  // Product density from which rows are kept as bitmaps
+  double bitmapRowDensity = 1.0 / 32;
+  // Product density from which operands are bit-packed and multiplied densely
+  double denseProductDensity = 0.05;
+  // Flops worth one worker thread; smaller products stay sequential
+  int64_t flopsPerThread = int64_t{1} << 18;
+  // Flops per output entry at or below which outer product beats row-wise
+  double outerProductCompression = 1.5;
+  // Chunks per pool thread in every work-stealing kernel (parallel and batch
+  // products, reordering, triangle counting), leaving slack for stealing
+  int chunksPerThread = 8;
+};
+
+/**
+ * @brief Returns the thresholds in effect.
+ *
+ * On first use they are loaded from defaultTuningPath(). A missing file
+ * leaves the defaults; an unreadable one is reported on std::clog and also
+ * leaves the defaults.
+ *
+ * @return The current thresholds
+ */
+const KernelThresholds &kernelThresholds();
+
+/**
+ * @brief Replaces the thresholds in effect. Not synchronized with multiplies
+ * running on other threads.
+ *
+ * @param thresholds The new thresholds
+ *
+ * @throws std::invalid_argument if a threshold is out of range.
+ */
+void setKernelThresholds(const KernelThresholds &thresholds);
+
+/**
+ * @brief Returns the tuning file read at startup: $MATMUL_TUNING_FILE if
+ * set, otherwise matmul_tuning.cfg in the working directory.
+ */
+std::string defaultTuningPath();
+
+/**
+ * @brief Reads thresholds from a tuning file of "key = value" lines; blank
+ * lines and lines starting with '#' are skipped, and keys left out keep
+ * their defaults.
+ *
+ * @param filename Path of the tuning file
+ * @return The thresholds it describes
+ *
+ * @throws std::runtime_error if the file cannot be opened, or a line has an
+ * unknown key or an unparsable value.
+ * @throws std::invalid_argument if a threshold is out of range.
+ */
+KernelThresholds loadKernelThresholds(const std::string &filename);
+
+/**
+ * @brief Writes thresholds to a tuning file that loadKernelThresholds() reads
+ * back exactly.
+ *
+ * @param thresholds Thresholds to write
+ * @param filename Path of the tuning file
+ *
+ * @throws std::runtime_error if the file cannot be written.
+ */
+void saveKernelThresholds(const KernelThresholds &thresholds,
+                          const std::string &filename);
+
+#endif // TUNING_H
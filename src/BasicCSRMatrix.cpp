@@ -0,0 +1,126 @@
+#include "../include/BasicCSRMatrix.h"
+#include "../include/MatrixChecks.h"
+#include "../include/SpGEMMWorkspace.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+
+// Per-thread column markers for kernels called without a workspace.
+static thread_local MarkerArray tlsMarker;
+
+// Throws unless every column of an N-column matrix fits Index.
+template <typename Index> static void requireColumnsFit(int N) {
+  if (N > 0 && static_cast<uint64_t>(N - 1) >
+                   static_cast<uint64_t>(std::numeric_limits<Index>::max())) {
+    throw std::overflow_error(std::to_string(N) +
+                              " columns do not fit the column index type.");
+  }
+}
+
+// Throws unless a matrix with nnz non-zeros can be addressed by Offset.
+template <typename Offset> static void requireOffsetsFit(size_t nnz) {
+  toOffset<Offset>(nnz);
+}
+
+template <typename Index, typename Offset>
+BasicCSRMatrix<Index, Offset>::BasicCSRMatrix(const CSRMatrix &csr) {
+  requirePattern("BasicCSRMatrix", csr);
+  std::tie(M, N) = csr.shape();
+  requireColumnsFit<Index>(N);
+  const auto &csrRowPtr = csr.getRowPtr();
+  const auto &csrColIdx = csr.getColIdx();
+  requireOffsetsFit<Offset>(static_cast<size_t>(csrRowPtr.back()));
+  rowPtr.assign(csrRowPtr.begin(), csrRowPtr.end());
+  colIdx.assign(csrColIdx.begin(), csrColIdx.end());
+}
+
+template <typename Index, typename Offset>
+BasicCSRMatrix<Index, Offset>::BasicCSRMatrix(std::vector<Offset> rowPtr,
+                                              std::vector<Index> colIdx, int M,
+                                              int N)
+    : rowPtr(std::move(rowPtr)), colIdx(std::move(colIdx)), M(M), N(N) {
+  if (M < 0 || N < 0 || this->rowPtr.size() != static_cast<size_t>(M) + 1 ||
+      this->rowPtr.front() != 0 ||
+      static_cast<size_t>(this->rowPtr.back()) != this->colIdx.size()) {
+    throw std::invalid_argument("CSR arrays do not describe a " +
+                                std::to_string(M) + "x" + std::to_string(N) +
+                                " matrix.");
+  }
+  requireColumnsFit<Index>(N);
+}
+
+template <typename Index, typename Offset>
+CSRMatrix BasicCSRMatrix<Index, Offset>::toCSR() const {
+  // CSRMatrix offsets are int, so this throws past 2^31 - 1 non-zeros
+  toOffset<int>(colIdx.size());
+  return CSRMatrix(std::vector<int>(rowPtr.begin(), rowPtr.end()),
+                   std::vector<int>(colIdx.begin(), colIdx.end()), M, N);
+}
+
+template <typename Index, typename Offset>
+BasicCSRMatrix<Index, Offset>
+BasicCSRMatrix<Index, Offset>::naiveMatmul(const BasicCSRMatrix &right) const {
+  requireMatmulShapes(shape(), right.shape());
+
+  MarkerArray &marker = tlsMarker;
+  marker.ensureSize(right.N);
+  std::vector<Offset> outRowPtr(M + 1, 0);
+  std::vector<Index> outColIdx;
+
+  for (int i = 0; i < M; ++i) {
+    const uint32_t stamp = marker.next();
+    for (Offset aPos = rowPtr[i]; aPos < rowPtr[i + 1]; ++aPos) {
+      const Index j = colIdx[aPos];
+      for (Offset bPos = right.rowPtr[j]; bPos < right.rowPtr[j + 1]; ++bPos) {
+        const Index k = right.colIdx[bPos];
+        if (marker.stamp[k] != stamp) {
+          marker.stamp[k] = stamp;
+          outColIdx.push_back(k);
+        }
+      }
+    }
+    std::sort(outColIdx.begin() + outRowPtr[i], outColIdx.end());
+    outRowPtr[i + 1] = toOffset<Offset>(outColIdx.size());
+  }
+  return BasicCSRMatrix(std::move(outRowPtr), std::move(outColIdx), M,
+                        right.N);
+}
+
+template <typename Index, typename Offset>
+const std::vector<Offset> &BasicCSRMatrix<Index, Offset>::getRowPtr() const {
+  return rowPtr;
+}
+
+template <typename Index, typename Offset>
+const std::vector<Index> &BasicCSRMatrix<Index, Offset>::getColIdx() const {
+  return colIdx;
+}
+
+template <typename Index, typename Offset>
+std::vector<Coord> BasicCSRMatrix<Index, Offset>::getCoords() const {
+  std::vector<Coord> coords;
+  coords.reserve(colIdx.size());
+  for (int row = 0; row < M; ++row) {
+    for (Offset p = rowPtr[row]; p < rowPtr[row + 1]; ++p) {
+      coords.push_back({row, static_cast<int>(colIdx[p])});
+    }
+  }
+  return coords;
+}
+
+template <typename Index, typename Offset>
+Offset BasicCSRMatrix<Index, Offset>::nnz() const {
+  return rowPtr.back();
+}
+
+template <typename Index, typename Offset>
+std::pair<int, int> BasicCSRMatrix<Index, Offset>::shape() const {
+  return {M, N};
+}
+
+template class BasicCSRMatrix<int32_t, int32_t>;
+template class BasicCSRMatrix<int32_t, int64_t>;
+template class BasicCSRMatrix<uint16_t, int32_t>;
+template class BasicCSRMatrix<uint16_t, uint16_t>;
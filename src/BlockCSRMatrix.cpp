@@ -0,0 +1,205 @@
+#include "../include/BlockCSRMatrix.h"
+#include "../include/MatrixChecks.h"
+#include "../include/SpGEMMWorkspace.h"
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+
+// A 64×64 tile costs 512 bytes against 4 bytes per entry in CSR, so it pays
+// off from 128 entries; require twice that before choosing 64×64 tiles.
+static constexpr int64_t kMinEntriesPer64Tile = 256;
+
+// Per-thread block-column markers.
+static thread_local MarkerArray tlsMarker;
+
+// Boolean product of two 8×8 tiles. For each k, the rows of a with bit k set
+// (spread to full bytes) select row k of b (copied into every byte).
+static uint64_t multiplyTile8(uint64_t a, uint64_t b) {
+  constexpr uint64_t kLowBits = 0x0101010101010101ULL;
+  uint64_t c = 0;
+  for (int k = 0; k < 8; ++k) {
+    const uint64_t rowsWithK = ((a >> k) & kLowBits) * 0xFF;
+    const uint64_t rowK = ((b >> (8 * k)) & 0xFF) * kLowBits;
+    c |= rowsWithK & rowK;
+  }
+  return c;
+}
+
+// Boolean product of two 64×64 tiles, ORed into c.
+static void multiplyTile64(const uint64_t *a, const uint64_t *b, uint64_t *c) {
+  for (int r = 0; r < 64; ++r) {
+    uint64_t acc = c[r];
+    for (uint64_t word = a[r]; word; word &= word - 1) {
+      acc |= b[std::countr_zero(word)];
+    }
+    c[r] = acc;
+  }
+}
+
+BlockCSRMatrix::BlockCSRMatrix(int M, int N, int tileSize)
+    : M(M), N(N), T(tileSize) {}
+
+int BlockCSRMatrix::wordsPerTile() const { return T == 8 ? 1 : 64; }
+
+BlockCSRMatrix::BlockCSRMatrix(const CSRMatrix &csr, int tileSize)
+    : T(tileSize) {
+  if (tileSize != 0 && tileSize != 8 && tileSize != 64) {
+    throw std::invalid_argument("Tile size must be 0, 8 or 64, got " +
+                                std::to_string(tileSize));
+  }
+  requirePattern("BlockCSRMatrix", csr);
+  std::tie(M, N) = csr.shape();
+  const auto &rowPtr = csr.getRowPtr();
+  const auto &colIdx = csr.getColIdx();
+  const int nnz = rowPtr.back();
+
+  MarkerArray &marker = tlsMarker;
+  if (T == 0) {
+    // Count the non-empty 64×64 blocks to judge how dense they are
+    marker.ensureSize((N + 63) / 64);
+    int64_t blocks = 0;
+    for (int I = 0; I * 64 < M; ++I) {
+      const uint32_t stamp = marker.next();
+      for (int p = rowPtr[I * 64]; p < rowPtr[std::min(M, I * 64 + 64)]; ++p) {
+        if (marker.stamp[colIdx[p] / 64] != stamp) {
+          marker.stamp[colIdx[p] / 64] = stamp;
+          ++blocks;
+        }
+      }
+    }
+    T = nnz >= blocks * kMinEntriesPer64Tile ? 64 : 8;
+  }
+
+  const int words = wordsPerTile();
+  const int blockCols = (N + T - 1) / T;
+  marker.ensureSize(blockCols);
+  std::vector<int> slot(blockCols);
+  blockRowPtr.assign((M + T - 1) / T + 1, 0);
+
+  for (int I = 0; I * T < M; ++I) {
+    const uint32_t stamp = marker.next();
+    const int firstTile = static_cast<int>(blockColIdx.size());
+    const int rowEnd = std::min(M, I * T + T);
+
+    // Collect the block columns of this block row, then set bits in order
+    for (int p = rowPtr[I * T]; p < rowPtr[rowEnd]; ++p) {
+      const int J = colIdx[p] / T;
+      if (marker.stamp[J] != stamp) {
+        marker.stamp[J] = stamp;
+        blockColIdx.push_back(J);
+      }
+    }
+    std::sort(blockColIdx.begin() + firstTile, blockColIdx.end());
+    for (int t = firstTile; t < static_cast<int>(blockColIdx.size()); ++t) {
+      slot[blockColIdx[t]] = t;
+    }
+    tiles.resize(blockColIdx.size() * words, 0);
+
+    for (int row = I * T; row < rowEnd; ++row) {
+      const int r = row - I * T;
+      for (int p = rowPtr[row]; p < rowPtr[row + 1]; ++p) {
+        const int c = colIdx[p] % T;
+        uint64_t *tile = tiles.data() + slot[colIdx[p] / T] * words;
+        if (T == 8) {
+          tile[0] |= uint64_t{1} << (r * 8 + c);
+        } else {
+          tile[r] |= uint64_t{1} << c;
+        }
+      }
+    }
+    blockRowPtr[I + 1] = toOffset(blockColIdx.size());
+  }
+}
+
+CSRMatrix BlockCSRMatrix::toCSR() const {
+  const int words = wordsPerTile();
+  std::vector<int> rowPtr(M + 1, 0);
+  std::vector<int> colIdx;
+  colIdx.reserve(nnz());
+
+  for (int row = 0; row < M; ++row) {
+    const int I = row / T;
+    const int r = row % T;
+    // Tiles are in block-column order, so the row's columns come out sorted
+    for (int t = blockRowPtr[I]; t < blockRowPtr[I + 1]; ++t) {
+      const uint64_t *tile = tiles.data() + static_cast<size_t>(t) * words;
+      uint64_t bits = T == 8 ? (tile[0] >> (r * 8)) & 0xFF : tile[r];
+      for (; bits; bits &= bits - 1) {
+        colIdx.push_back(blockColIdx[t] * T + std::countr_zero(bits));
+      }
+    }
+    rowPtr[row + 1] = toOffset(colIdx.size());
+  }
+  return CSRMatrix(std::move(rowPtr), std::move(colIdx), M, N);
+}
+
+BlockCSRMatrix BlockCSRMatrix::naiveMatmul(const BlockCSRMatrix &right) const {
+  requireMatmulShapes(shape(), right.shape());
+  if (this->T != right.T) {
+    throw std::invalid_argument("Tile size mismatch: " + std::to_string(T) +
+                                " != " + std::to_string(right.T));
+  }
+
+  const int words = wordsPerTile();
+  const int blockCols = (right.N + T - 1) / T;
+  BlockCSRMatrix result(this->M, right.N, T);
+  result.blockRowPtr.assign(blockRowPtr.size(), 0);
+
+  MarkerArray &marker = tlsMarker;
+  marker.ensureSize(blockCols);
+  std::vector<uint64_t> accum(static_cast<size_t>(blockCols) * words);
+  std::vector<int> touched;
+
+  for (int I = 0; I + 1 < static_cast<int>(blockRowPtr.size()); ++I) {
+    const uint32_t stamp = marker.next();
+    touched.clear();
+
+    for (int a = blockRowPtr[I]; a < blockRowPtr[I + 1]; ++a) {
+      const int K = blockColIdx[a];
+      const uint64_t *aTile = tiles.data() + static_cast<size_t>(a) * words;
+      for (int b = right.blockRowPtr[K]; b < right.blockRowPtr[K + 1]; ++b) {
+        const int J = right.blockColIdx[b];
+        uint64_t *cTile = accum.data() + static_cast<size_t>(J) * words;
+        if (marker.stamp[J] != stamp) {
+          marker.stamp[J] = stamp;
+          touched.push_back(J);
+          std::fill(cTile, cTile + words, 0);
+        }
+        const uint64_t *bTile =
+            right.tiles.data() + static_cast<size_t>(b) * words;
+        if (T == 8) {
+          cTile[0] |= multiplyTile8(aTile[0], bTile[0]);
+        } else {
+          multiplyTile64(aTile, bTile, cTile);
+        }
+      }
+    }
+
+    std::sort(touched.begin(), touched.end());
+    for (int J : touched) {
+      const uint64_t *cTile = accum.data() + static_cast<size_t>(J) * words;
+      if (std::any_of(cTile, cTile + words, [](uint64_t w) { return w; })) {
+        result.blockColIdx.push_back(J);
+        result.tiles.insert(result.tiles.end(), cTile, cTile + words);
+      }
+    }
+    result.blockRowPtr[I + 1] = toOffset(result.blockColIdx.size());
+  }
+  return result;
+}
+
+int BlockCSRMatrix::tileSize() const { return T; }
+
+size_t BlockCSRMatrix::numTiles() const { return blockColIdx.size(); }
+
+size_t BlockCSRMatrix::nnz() const {
+  size_t count = 0;
+  for (uint64_t word : tiles) {
+    count += std::popcount(word);
+  }
+  return count;
+}
+
+std::pair<int, int> BlockCSRMatrix::shape() const { return {M, N}; }
@@ -1,22 +1,62 @@
 #include "../include/CSRMatrix.h"
+#include "../include/MatrixChecks.h"
+#include "../include/ProductPlanner.h"
+#include "../include/Scheduler.h"
+#include "../include/Semiring.h"
+#include "../include/SetIntersection.h"
+#include "../include/SpGEMMWorkspace.h"
+#include "../include/Tuning.h"
 #include <Estimator.h>
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <fstream>
+#include <iterator>
+#include <memory>
+#include <optional>
 #include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
 
 // Comparator for sorting coords by row then col
 static bool compareRowCol(const Coord &a, const Coord &b) {
   return a.row != b.row ? a.row < b.row : a.col < b.col;
 }
 
-static std::vector<int> visited;
+void requirePattern(const char *name, const CSRMatrix &A) {
+  if (!A.getValues().empty()) {
+    throw std::invalid_argument(std::string(name) +
+                                ": matrix has values, which this "
+                                "pattern-only kernel would drop");
+  }
+}
 
-inline void ensureVisitedSize(int numCols) {
-  if (static_cast<int>(visited.size()) < numCols) {
-    visited.assign(numCols, -1);
+// Resolves a requested worker count, where 0 means hardware concurrency.
+static int resolveThreads(int numThreads) {
+  if (numThreads > 0) {
+    return numThreads;
   }
+  return static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
 }
 
+// Runs fn(t) for every t in [0, numThreads), with t = 0 on the calling thread.
+template <typename Fn> static void runThreads(int numThreads, Fn &&fn) {
+  std::vector<std::thread> workers;
+  workers.reserve(numThreads - 1);
+  for (int t = 1; t < numThreads; ++t) {
+    workers.emplace_back(fn, t);
+  }
+  fn(0);
+  for (auto &worker : workers) {
+    worker.join();
+  }
+}
+
+// Per-thread column markers for kernels called without a workspace.
+static thread_local MarkerArray tlsMarker;
+
 CSRMatrix::CSRMatrix(const std::string &filename) {
   std::ifstream fin(filename);
   if (!fin.is_open()) {
@@ -135,6 +175,29 @@ CSRMatrix::CSRMatrix(const std::vector<Coord> &coords, int M, int N)
   }
 }
 
+CSRMatrix::CSRMatrix(std::vector<int> rowPtr, std::vector<int> colIdx, int M,
+                     int N)
+    : rowPtr(std::move(rowPtr)), colIdx(std::move(colIdx)), M(M), N(N) {
+  if (M < 0 || N < 0 || static_cast<int>(this->rowPtr.size()) != M + 1 ||
+      this->rowPtr.front() != 0 ||
+      this->rowPtr.back() != static_cast<int>(this->colIdx.size())) {
+    throw std::invalid_argument("CSR arrays do not describe a " +
+                                std::to_string(M) + "x" + std::to_string(N) +
+                                " matrix.");
+  }
+}
+
+CSRMatrix::CSRMatrix(std::vector<int> rowPtr, std::vector<int> colIdx,
+                     std::vector<double> values, int M, int N)
+    : CSRMatrix(std::move(rowPtr), std::move(colIdx), M, N) {
+  if (values.size() != this->colIdx.size()) {
+    throw std::invalid_argument("CSR values do not match the " +
+                                std::to_string(this->colIdx.size()) +
+                                " non-zeros.");
+  }
+  this->values = std::move(values);
+}
+
 std::vector<Coord> CSRMatrix::getCoords() const {
   std::vector<Coord> coords;
 
@@ -149,105 +212,393 @@ std::vector<Coord> CSRMatrix::getCoords() const {
   return coords;
 }
 
+const std::vector<int> &CSRMatrix::getRowPtr() const { return rowPtr; }
+
+const std::vector<int> &CSRMatrix::getColIdx() const { return colIdx; }
+
+const std::vector<double> &CSRMatrix::getValues() const { return values; }
+
 CSRMatrix CSRMatrix::naiveMatmul(const CSRMatrix &right) const {
-  auto [rowsA, colsA] = this->shape();
-  auto [rowsB, colsB] = right.shape();
-  if (colsA != rowsB) {
-    throw std::invalid_argument("matmul dimension mismatch: "
-                                "Left cols (" +
-                                std::to_string(colsA) + ") != Right rows (" +
-                                std::to_string(rowsB) + ")");
+  requireMatmulShapes(this->shape(), right.shape());
+  requirePattern("naiveMatmul", *this);
+  requirePattern("naiveMatmul", right);
+
+  CSRMatrix result;
+  result.M = this->M;
+  result.N = right.N;
+  gustavson(right, tlsMarker, result.rowPtr, result.colIdx);
+
+  return result;
+}
+
+CSRMatrix CSRMatrix::optimizedMatmul(const CSRMatrix &right, double estimate) {
+  requireMatmulShapes(this->shape(), right.shape());
+  requirePattern("optimizedMatmul", *this);
+  requirePattern("optimizedMatmul", right);
+
+  if (chooseProductFormat(estimate, this->M, right.N) ==
+      ProductFormat::Dense) {
+    return toCSR(multiplyAs(*this, right, ProductFormat::Dense));
   }
 
-  // Row Pointers
-  std::vector<int> resultRowPtr(rowsA + 1, 0);
-  // Column Indices
-  std::vector<int> resultColIdx;
-  // Reserve space of last row val
-  resultColIdx.reserve(resultRowPtr.back());
+  CSRMatrix result;
+  result.M = this->M;
+  result.N = right.N;
+  // Reserve space for the estimated number of non-zeros
+  result.colIdx.reserve(static_cast<size_t>(estimate));
+  gustavson(right, tlsMarker, result.rowPtr, result.colIdx);
 
-  // std::vector<std::unordered_set<int>> resSets(rowsA);
-  ensureVisitedSize(colsB);
+  return result;
+}
 
-  for (int i = 0; i < rowsA; ++i) {
-    const size_t before = resultColIdx.size();
+void CSRMatrix::multiplyInto(const CSRMatrix &right, CSRMatrix &out) const {
+  multiplyInto(right, out, tlsMarker);
+}
 
-    for (int aPos = rowPtr[i]; aPos < rowPtr[i + 1]; ++aPos) {
-      // column index in A = row index in B
-      int j = colIdx[aPos];
+void CSRMatrix::multiplyInto(const CSRMatrix &right, CSRMatrix &out,
+                             SpGEMMWorkspace &workspace) const {
+  multiplyInto(right, out, workspace.scratch().marker);
+}
+
+void CSRMatrix::multiplyInto(const CSRMatrix &right, CSRMatrix &out,
+                             MarkerArray &marker) const {
+  requireMatmulShapes(this->shape(), right.shape());
+  requirePattern("multiplyInto", *this);
+  requirePattern("multiplyInto", right);
+
+  if (&out == this || &out == &right) {
+    // The kernel reads the operands while writing out, so an aliased output
+    // is built aside and then takes over the new buffers.
+    CSRMatrix product;
+    product.M = this->M;
+    product.N = right.N;
+    gustavson(right, marker, product.rowPtr, product.colIdx);
+    out = std::move(product);
+    return;
+  }
+
+  gustavson(right, marker, out.rowPtr, out.colIdx);
+  out.values.clear();
+  out.M = this->M;
+  out.N = right.N;
+}
+
+void CSRMatrix::multiplyAccumulate(const CSRMatrix &right,
+                                   CSRMatrix &accum) const {
+  std::vector<int> outRowPtr, outColIdx;
+  multiplyAccumulate(right, accum, tlsMarker, outRowPtr, outColIdx);
+}
 
+void CSRMatrix::multiplyAccumulate(const CSRMatrix &right, CSRMatrix &accum,
+                                   SpGEMMWorkspace &workspace) const {
+  auto &scratch = workspace.scratch();
+  multiplyAccumulate(right, accum, scratch.marker, scratch.rowPtr,
+                     scratch.colIdx);
+}
+
+void CSRMatrix::multiplyAccumulate(const CSRMatrix &right, CSRMatrix &accum,
+                                   MarkerArray &marker,
+                                   std::vector<int> &outRowPtr,
+                                   std::vector<int> &outColIdx) const {
+  requireMatmulShapes(this->shape(), right.shape());
+  requirePattern("multiplyAccumulate", *this);
+  requirePattern("multiplyAccumulate", right);
+  requirePattern("multiplyAccumulate", accum);
+  if (accum.shape() != std::pair<int, int>(this->M, right.N)) {
+    throw std::invalid_argument(
+        "accumulator dimension mismatch: accumulator must be " +
+        std::to_string(this->M) + "x" + std::to_string(right.N) + ", got " +
+        std::to_string(accum.M) + "x" + std::to_string(accum.N));
+  }
+
+  // The union is built in separate buffers, so accum may alias an operand
+  marker.ensureSize(right.N);
+  outRowPtr.assign(M + 1, 0);
+  outColIdx.clear();
+  outColIdx.reserve(accum.colIdx.size());
+
+  for (int i = 0; i < M; ++i) {
+    const uint32_t stamp = marker.next();
+
+    // Preload the accumulated row
+    for (int cPos = accum.rowPtr[i]; cPos < accum.rowPtr[i + 1]; ++cPos) {
+      const int k = accum.colIdx[cPos];
+      marker.stamp[k] = stamp;
+      outColIdx.push_back(k);
+    }
+    const size_t preloaded = outColIdx.size();
+
+    for (int aPos = rowPtr[i]; aPos < rowPtr[i + 1]; ++aPos) {
+      const int j = colIdx[aPos];
       for (int bPos = right.rowPtr[j]; bPos < right.rowPtr[j + 1]; ++bPos) {
-        int k = right.colIdx[bPos];
-        if (visited[k] != i) {
-          visited[k] = i;
-          resultColIdx.push_back(k);
+        const int k = right.colIdx[bPos];
+        if (marker.stamp[k] != stamp) {
+          marker.stamp[k] = stamp;
+          outColIdx.push_back(k);
         }
       }
     }
-    std::sort(resultColIdx.begin() + before, resultColIdx.end());
-    resultRowPtr[i + 1] = static_cast<int>(resultColIdx.size());
+
+    // The marker kept the row free of duplicates; sorting it in place
+    // avoids the temporary buffer a merge would allocate per row
+    if (outColIdx.size() != preloaded) {
+      std::sort(outColIdx.begin() + outRowPtr[i], outColIdx.end());
+    }
+    outRowPtr[i + 1] = toOffset(outColIdx.size());
   }
 
-  CSRMatrix result = *this;
-  result.M = rowsA;
-  result.N = colsB;
-  result.rowPtr = std::move(resultRowPtr);
-  result.colIdx = std::move(resultColIdx);
+  accum.rowPtr.swap(outRowPtr);
+  accum.colIdx.swap(outColIdx);
+  accum.values.clear();
+}
+
+CSRMatrix CSRMatrix::naiveMatmul(const CSRMatrix &right,
+                                 SpGEMMWorkspace &workspace) const {
+  requireMatmulShapes(this->shape(), right.shape());
+  requirePattern("naiveMatmul", *this);
+  requirePattern("naiveMatmul", right);
+
+  auto &scratch = workspace.scratch();
+  gustavson(right, scratch.marker, scratch.rowPtr, scratch.colIdx);
+
+  // Exact-size copies: the workspace keeps the grown buffers for next time
+  CSRMatrix result;
+  result.M = this->M;
+  result.N = right.N;
+  result.rowPtr = scratch.rowPtr;
+  result.colIdx = scratch.colIdx;
 
   return result;
 }
 
-CSRMatrix CSRMatrix::optimizedMatmul(const CSRMatrix &right, double estimate) {
-  // Check for matrix dimension mismatch
-  auto [rowsA, colsA] = this->shape();
-  auto [rowsB, colsB] = right.shape();
-  if (colsA != rowsB) {
-    throw std::invalid_argument("matmul dimension mismatch: "
-                                "Left cols (" +
-                                std::to_string(colsA) + ") != Right rows (" +
-                                std::to_string(rowsB) + ")");
+CSRMatrix CSRMatrix::optimizedMatmul(const CSRMatrix &right, double estimate,
+                                     SpGEMMWorkspace &workspace) {
+  requireMatmulShapes(this->shape(), right.shape());
+  requirePattern("optimizedMatmul", *this);
+  requirePattern("optimizedMatmul", right);
+  if (chooseProductFormat(estimate, this->M, right.N) ==
+      ProductFormat::Dense) {
+    return toCSR(multiplyAs(*this, right, ProductFormat::Dense));
   }
 
-  // Row Pointers
-  std::vector<int> resultRowPtr(rowsA + 1, 0);
-  // Column Indices
-  std::vector<int> resultColIdx;
-  // Reserve space of last row val
-  resultColIdx.reserve(static_cast<size_t>(estimate));
+  auto &scratch = workspace.scratch();
+  scratch.colIdx.reserve(static_cast<size_t>(estimate));
+  gustavson(right, scratch.marker, scratch.rowPtr, scratch.colIdx);
 
-  // std::vector<std::unordered_set<int>> resSets(rowsA);
-  ensureVisitedSize(colsB);
+  // Exact-size copies: the workspace keeps the grown buffers for next time
+  CSRMatrix result;
+  result.M = this->M;
+  result.N = right.N;
+  result.rowPtr = scratch.rowPtr;
+  result.colIdx = scratch.colIdx;
 
-  for (int i = 0; i < rowsA; ++i) {
-    const size_t before = resultColIdx.size();
+  return result;
+}
 
-    for (int aPos = rowPtr[i]; aPos < rowPtr[i + 1]; ++aPos) {
-      // column index in A = row index in B
-      int j = colIdx[aPos];
+// Per-thread dense value accumulator for the valued semiring kernels, grown to
+// at least numCols slots. Only columns stamped in the current row are read.
+static double *valueAccumulator(int numCols) {
+  static thread_local std::vector<double> acc;
+  if (acc.size() < static_cast<size_t>(numCols)) {
+    acc.resize(numCols);
+  }
+  return acc.data();
+}
 
-      for (int bPos = right.rowPtr[j]; bPos < right.rowPtr[j + 1]; ++bPos) {
-        int k = right.colIdx[bPos];
-        if (visited[k] != i) {
-          visited[k] = i;
-          resultColIdx.push_back(k);
+// Calls kernel(leftValued, rightValued) with std::bool_constant flags telling
+// whether each operand stores values, so row loops test that once per product
+// instead of once per entry. Pattern-only semirings never read values.
+template <typename Semiring, typename Kernel>
+static void withValueFlags(const CSRMatrix &left, const CSRMatrix &right,
+                           Kernel &&kernel) {
+  if constexpr (!Semiring::hasValues) {
+    kernel(std::false_type{}, std::false_type{});
+  } else {
+    const bool leftValued = !left.getValues().empty();
+    const bool rightValued = !right.getValues().empty();
+    if (leftValued && rightValued) {
+      kernel(std::true_type{}, std::true_type{});
+    } else if (leftValued) {
+      kernel(std::true_type{}, std::false_type{});
+    } else if (rightValued) {
+      kernel(std::false_type{}, std::true_type{});
+    } else {
+      kernel(std::false_type{}, std::false_type{});
+    }
+  }
+}
+
+// Value of the entry at pos, or the semiring's one() for a pattern operand.
+template <typename Semiring, bool Valued>
+static double entryValue(const std::vector<double> &values, int pos) {
+  if constexpr (Valued) {
+    return values[pos];
+  } else {
+    return Semiring::one();
+  }
+}
+
+// Gustavson's loop for one output row over the left entries [aBegin, aEnd).
+// Appends the row's new columns to cols, unsorted; valued semirings also fold
+// every product into acc. Columns stamped beforehand only accumulate.
+template <typename Semiring, bool LeftValued, bool RightValued>
+static void multiplyRow(const CSRMatrix &left, const CSRMatrix &right,
+                        int aBegin, int aEnd, MarkerArray &marker,
+                        uint32_t stamp, std::vector<int> &cols, double *acc) {
+  const std::vector<int> &leftCols = left.getColIdx();
+  const std::vector<int> &rightRowPtr = right.getRowPtr();
+  const std::vector<int> &rightCols = right.getColIdx();
+
+  for (int aPos = aBegin; aPos < aEnd; ++aPos) {
+    // column index in A = row index in B
+    const int j = leftCols[aPos];
+
+    if constexpr (!Semiring::hasValues) {
+      for (int bPos = rightRowPtr[j]; bPos < rightRowPtr[j + 1]; ++bPos) {
+        const int k = rightCols[bPos];
+        if (marker.stamp[k] != stamp) {
+          marker.stamp[k] = stamp;
+          cols.push_back(k);
+        }
+      }
+    } else {
+      const double a =
+          entryValue<Semiring, LeftValued>(left.getValues(), aPos);
+      for (int bPos = rightRowPtr[j]; bPos < rightRowPtr[j + 1]; ++bPos) {
+        const int k = rightCols[bPos];
+        const double ab = Semiring::multiply(
+            a, entryValue<Semiring, RightValued>(right.getValues(), bPos));
+        if (marker.stamp[k] != stamp) {
+          marker.stamp[k] = stamp;
+          acc[k] = ab;
+          cols.push_back(k);
+        } else {
+          acc[k] = Semiring::add(acc[k], ab);
         }
       }
     }
-    std::sort(resultColIdx.begin() + before, resultColIdx.end());
-    resultRowPtr[i + 1] = static_cast<int>(resultColIdx.size());
   }
+}
 
-  CSRMatrix result = *this;
-  result.M = rowsA;
-  result.N = colsB;
-  result.rowPtr = std::move(resultRowPtr);
-  result.colIdx = std::move(resultColIdx);
+template <typename Semiring>
+void CSRMatrix::gustavson(const CSRMatrix &right, MarkerArray &marker,
+                          std::vector<int> &outRowPtr,
+                          std::vector<int> &outColIdx,
+                          std::vector<double> *outValues) const {
+  marker.ensureSize(right.N);
+  outRowPtr.assign(M + 1, 0);
+  outColIdx.clear();
+  double *acc = nullptr;
+  if constexpr (Semiring::hasValues) {
+    outValues->clear();
+    acc = valueAccumulator(right.N);
+  }
+
+  withValueFlags<Semiring>(*this, right, [&](auto leftValued,
+                                             auto rightValued) {
+    constexpr bool kLeftValued = decltype(leftValued)::value;
+    constexpr bool kRightValued = decltype(rightValued)::value;
+    for (int i = 0; i < M; ++i) {
+      const uint32_t stamp = marker.next();
+      multiplyRow<Semiring, kLeftValued, kRightValued>(
+          *this, right, rowPtr[i], rowPtr[i + 1], marker, stamp, outColIdx,
+          acc);
+      std::sort(outColIdx.begin() + outRowPtr[i], outColIdx.end());
+      if constexpr (Semiring::hasValues) {
+        for (size_t p = outRowPtr[i]; p < outColIdx.size(); ++p) {
+          outValues->push_back(acc[outColIdx[p]]);
+        }
+      }
+      outRowPtr[i + 1] = toOffset(outColIdx.size());
+    }
+  });
+}
+
+CSRMatrix CSRMatrix::maskedMatmul(const CSRMatrix &right,
+                                  const CSRMatrix &mask,
+                                  bool complement) const {
+  requireMatmulShapes(this->shape(), right.shape());
+  requirePattern("maskedMatmul", *this);
+  requirePattern("maskedMatmul", right);
+  if (mask.shape() != std::pair<int, int>(this->M, right.N)) {
+    throw std::invalid_argument("mask dimension mismatch: mask must be " +
+                                std::to_string(this->M) + "x" +
+                                std::to_string(right.N));
+  }
+
+  MarkerArray &marker = tlsMarker;
+  marker.ensureSize(right.N);
+
+  CSRMatrix result;
+  result.M = this->M;
+  result.N = right.N;
+  result.rowPtr.assign(this->M + 1, 0);
+
+  for (int i = 0; i < this->M; ++i) {
+    const int maskBegin = mask.rowPtr[i];
+    const int maskEnd = mask.rowPtr[i + 1];
+    const int maskLen = maskEnd - maskBegin;
+
+    // A masked row with an empty mask row has nothing to compute
+    if (!complement && maskLen == 0) {
+      result.rowPtr[i + 1] = toOffset(result.colIdx.size());
+      continue;
+    }
+
+    // Mask columns carry maskStamp; products found in the row carry hitStamp
+    const uint32_t maskStamp = marker.next();
+    const uint32_t hitStamp = marker.next();
+    for (int m = maskBegin; m < maskEnd; ++m) {
+      marker.stamp[mask.colIdx[m]] = maskStamp;
+    }
+
+    if (!complement) {
+      int found = 0;
+      for (int aPos = rowPtr[i]; aPos < rowPtr[i + 1] && found < maskLen;
+           ++aPos) {
+        const int j = colIdx[aPos];
+        for (int bPos = right.rowPtr[j]; bPos < right.rowPtr[j + 1]; ++bPos) {
+          const int k = right.colIdx[bPos];
+          if (marker.stamp[k] == maskStamp) {
+            marker.stamp[k] = hitStamp;
+            // Saturated: every masked column of this row is already set
+            if (++found == maskLen) {
+              break;
+            }
+          }
+        }
+      }
+
+      // The mask row is sorted, so the hits come out in column order
+      for (int m = maskBegin; m < maskEnd; ++m) {
+        if (marker.stamp[mask.colIdx[m]] == hitStamp) {
+          result.colIdx.push_back(mask.colIdx[m]);
+        }
+      }
+    } else {
+      const size_t before = result.colIdx.size();
+      for (int aPos = rowPtr[i]; aPos < rowPtr[i + 1]; ++aPos) {
+        const int j = colIdx[aPos];
+        for (int bPos = right.rowPtr[j]; bPos < right.rowPtr[j + 1]; ++bPos) {
+          const int k = right.colIdx[bPos];
+          if (marker.stamp[k] != maskStamp && marker.stamp[k] != hitStamp) {
+            marker.stamp[k] = hitStamp;
+            result.colIdx.push_back(k);
+          }
+        }
+      }
+      std::sort(result.colIdx.begin() + before, result.colIdx.end());
+    }
+
+    result.rowPtr[i + 1] = toOffset(result.colIdx.size());
+  }
 
   return result;
 }
 
 std::vector<CSRMatrix>
-CSRMatrix::batchNaiveMatmul(const std::vector<CSRMatrix> &rights) const {
+CSRMatrix::batchNaiveMatmul(const std::vector<CSRMatrix> &rights,
+                            bool fused) const {
   auto [rowsA, colsA] = this->shape();
 
   // Validate all matrix dimensions first
@@ -258,6 +609,10 @@ CSRMatrix::batchNaiveMatmul(const std::vector<CSRMatrix> &rights) const {
     }
   }
 
+  if (fused) {
+    return fusedBatchMatmul(rights, {});
+  }
+
   std::vector<CSRMatrix> results;
   results.reserve(rights.size());
 
@@ -271,7 +626,7 @@ CSRMatrix::batchNaiveMatmul(const std::vector<CSRMatrix> &rights) const {
 
 std::vector<CSRMatrix>
 CSRMatrix::batchOptimizedMatmul(const std::vector<CSRMatrix> &rights,
-                                double epsilon) const {
+                                double epsilon, bool fused) const {
 
   for (const auto &right : rights) {
     if (this->N != right.shape().first) {
@@ -279,57 +634,1041 @@ CSRMatrix::batchOptimizedMatmul(const std::vector<CSRMatrix> &rights,
     }
   }
 
+  // The left operand is shared by the whole batch, so its hashed
+  // coordinates are built once.
+  CoordListMatrix forEstimateA(this->getCoords(), this->M, this->N);
+
+  std::vector<size_t> estimates;
+  estimates.reserve(rights.size());
+  for (const auto &right : rights) {
+    auto [rightM, rightN] = right.shape();
+    CoordListMatrix forEstimateB(right.getCoords(), rightM, rightN);
+
+    // Call the estimator for the current left/right pair
+    // The estimator uses the hashed coordinates from each matrix
+    estimates.push_back(static_cast<size_t>(
+        estimateProductSize(forEstimateA.getHashedCoords(),
+                            forEstimateB.getHashedCoords(), epsilon)));
+  }
+
+  if (fused) {
+    return fusedBatchMatmul(rights, estimates);
+  }
+
   std::vector<CSRMatrix> results;
   results.reserve(rights.size());
 
-  std::vector<std::vector<int>> leftGroups(this->N);
+  std::vector<int> colPtrA, rowIdxA;
+  toCSC(colPtrA, rowIdxA);
 
-  for (int row = 0; row < this->M; ++row) {
-    for (int idx = rowPtr[row]; idx < rowPtr[row + 1]; ++idx) {
-      int col = colIdx[idx];
-      leftGroups[col].push_back(row);
+  // Instead of iterating by left row (as in naive), iterate over join keys
+  // directly
+  for (size_t b = 0; b < rights.size(); ++b) {
+    results.push_back(
+        outerProduct(colPtrA, rowIdxA, this->M, rights[b], 0, estimates[b]));
+  }
+  return results;
+}
+
+std::vector<CSRMatrix>
+CSRMatrix::fusedBatchMatmul(const std::vector<CSRMatrix> &rights,
+                            const std::vector<size_t> &reserveHints) const {
+  const size_t numRights = rights.size();
+
+  // Each B_i owns a slice of the concatenated column space, so one marker
+  // array deduplicates every product of the current row.
+  std::vector<int> colOffset(numRights + 1, 0);
+  for (size_t b = 0; b < numRights; ++b) {
+    colOffset[b + 1] = colOffset[b] + rights[b].N;
+  }
+  MarkerArray &marker = tlsMarker;
+  marker.ensureSize(colOffset.back());
+
+  // Per-B_i output segments, filled in place and moved into the results
+  std::vector<CSRMatrix> results;
+  results.reserve(numRights);
+  for (size_t b = 0; b < numRights; ++b) {
+    results.push_back(CSRMatrix());
+    results[b].M = this->M;
+    results[b].N = rights[b].N;
+    results[b].rowPtr.assign(this->M + 1, 0);
+    if (!reserveHints.empty()) {
+      results[b].colIdx.reserve(reserveHints[b]);
     }
   }
 
-  // Process each right matrix in the batch
-  for (const auto &right : rights) {
-    std::vector<std::vector<int>> rightGroups(right.M);
-    for (int row = 0; row < right.M; ++row) {
-      for (int idx = right.rowPtr[row]; idx < right.rowPtr[row + 1]; ++idx) {
-        int col = right.colIdx[idx];
-        rightGroups[row].push_back(col);
+  for (int i = 0; i < this->M; ++i) {
+    const uint32_t stamp = marker.next();
+
+    for (int aPos = rowPtr[i]; aPos < rowPtr[i + 1]; ++aPos) {
+      // column index in A = row index in every B_i
+      const int j = colIdx[aPos];
+
+      for (size_t b = 0; b < numRights; ++b) {
+        const CSRMatrix &right = rights[b];
+        uint32_t *slice = marker.stamp.data() + colOffset[b];
+        auto &out = results[b].colIdx;
+
+        for (int bPos = right.rowPtr[j]; bPos < right.rowPtr[j + 1]; ++bPos) {
+          const int k = right.colIdx[bPos];
+          if (slice[k] != stamp) {
+            slice[k] = stamp;
+            out.push_back(k);
+          }
+        }
       }
     }
 
-    CoordListMatrix forEstimateA(this->getCoords(), this->M, this->N);
-    auto [rightM, rightN] = right.shape();
-    CoordListMatrix forEstimateB(right.getCoords(), rightM, rightN);
+    for (size_t b = 0; b < numRights; ++b) {
+      auto &out = results[b].colIdx;
+      std::sort(out.begin() + results[b].rowPtr[i], out.end());
+      results[b].rowPtr[i + 1] = toOffset(out.size());
+    }
+  }
 
-    // Call the estimator for the current left/right pair
-    // The estimator uses the hashed coordinates from each matrix
-    double estimatedJoinSize =
-        estimateProductSize(forEstimateA.getHashedCoords(),
-                            forEstimateB.getHashedCoords(), epsilon);
-
-    // Preallocate storage for the join result using the estimated join size.
-    std::vector<Coord> resultCoords;
-    resultCoords.reserve(static_cast<size_t>(estimatedJoinSize));
-
-    // Instead of iterating by left row (as in naive), iterate over join keys
-    // directly
-    for (size_t joinKey = 0; joinKey < this->N; joinKey++) {
-      if (!leftGroups[joinKey].empty() && !rightGroups[joinKey].empty()) {
-        for (int leftRow : leftGroups[joinKey]) {
-          for (int rightCol : rightGroups[joinKey]) {
-            resultCoords.push_back({leftRow, rightCol});
+  return results;
+}
+
+CSRMatrix CSRMatrix::outerProductMatmul(const CSRMatrix &right,
+                                        int numThreads) const {
+  requireMatmulShapes(this->shape(), right.shape());
+  requirePattern("outerProductMatmul", *this);
+  requirePattern("outerProductMatmul", right);
+
+  std::vector<int> colPtrA, rowIdxA;
+  toCSC(colPtrA, rowIdxA, numThreads);
+  return outerProduct(colPtrA, rowIdxA, this->M, right, numThreads);
+}
+
+template <typename Semiring> class CSRMatrix::RowWiseJob {
+public:
+  // The product is written to result, whose capacity is reused. With an
+  // accumulator, each output row also holds that row of accum.
+  RowWiseJob(const CSRMatrix &left, const CSRMatrix &right, CSRMatrix &result,
+             const CSRMatrix *accum = nullptr)
+      : left(left), right(right), accum(accum), result(result) {}
+
+  // Work of each A non-zero is the length of the B row it selects.
+  void computeWork() {
+    nnzWork.resize(left.colIdx.size());
+    totalWork = 0;
+    for (size_t p = 0; p < left.colIdx.size(); ++p) {
+      const int j = left.colIdx[p];
+      nnzWork[p] = right.rowPtr[j + 1] - right.rowPtr[j];
+      totalWork += nnzWork[p];
+    }
+  }
+
+  [[nodiscard]] int64_t flops() const { return totalWork; }
+
+  void partition(int numChunks) {
+    chunks = partitionRowsByWork(left.rowPtr, nnzWork, numChunks);
+    std::vector<int64_t>().swap(nnzWork);
+    outputs.resize(chunks.size());
+
+    // Pieces of the same heavy row form one output unit
+    for (int c = 0; c < static_cast<int>(chunks.size()); ++c) {
+      if (c > 0 && chunks[c].partialRow && chunks[c - 1].partialRow &&
+          chunks[c].rowBegin == chunks[c - 1].rowBegin) {
+        units.back().second = c;
+      } else {
+        units.emplace_back(c, c);
+      }
+    }
+  }
+
+  // Phase 1: Gustavson's loop over each chunk.
+  void addMultiplyTasks(std::vector<std::function<void()>> &tasks) {
+    for (size_t c = 0; c < chunks.size(); ++c) {
+      tasks.emplace_back([this, c] { multiplyChunk(c); });
+    }
+  }
+
+  // Phase 2: union the pieces of every split row.
+  void addMergeTasks(std::vector<std::function<void()>> &tasks) {
+    for (const auto &[first, last] : units) {
+      if (first != last) {
+        tasks.emplace_back([this, first, last] { mergePieces(first, last); });
+      }
+    }
+  }
+
+  // Phase 3: build rowPtr, then copy each unit into its slice of colIdx
+  // (and of values, for valued semirings).
+  void addCopyTasks(std::vector<std::function<void()>> &tasks) {
+    result.M = left.M;
+    result.N = right.N;
+    result.values.clear();
+    result.rowPtr.assign(left.M + 1, 0);
+    for (const auto &[first, last] : units) {
+      const RowChunk &chunk = chunks[first];
+      for (int r = chunk.rowBegin; r < chunk.rowEnd; ++r) {
+        result.rowPtr[r + 1] = outputs[first].rowNnz[r - chunk.rowBegin];
+      }
+    }
+    for (int r = 0; r < left.M; ++r) {
+      result.rowPtr[r + 1] = toOffset(static_cast<size_t>(result.rowPtr[r]) +
+                                      result.rowPtr[r + 1]);
+    }
+    result.colIdx.resize(result.rowPtr.back());
+    if constexpr (Semiring::hasValues) {
+      result.values.resize(result.rowPtr.back());
+    }
+
+    for (const auto &unit : units) {
+      const int first = unit.first;
+      tasks.emplace_back([this, first] {
+        const int offset = result.rowPtr[chunks[first].rowBegin];
+        const auto &cols = outputs[first].cols;
+        std::copy(cols.begin(), cols.end(), result.colIdx.begin() + offset);
+        if constexpr (Semiring::hasValues) {
+          const auto &vals = outputs[first].vals;
+          std::copy(vals.begin(), vals.end(), result.values.begin() + offset);
+        }
+      });
+    }
+  }
+
+private:
+  struct Output {
+    std::vector<int> rowNnz; // one entry per row of the chunk
+    std::vector<int> cols;   // sorted column indices, row after row
+    std::vector<double> vals; // values parallel to cols (valued semirings)
+  };
+
+  void multiplyChunk(size_t c) {
+    withValueFlags<Semiring>(left, right, [&](auto leftValued,
+                                              auto rightValued) {
+      multiplyChunk<decltype(leftValued)::value,
+                    decltype(rightValued)::value>(c);
+    });
+  }
+
+  template <bool LeftValued, bool RightValued> void multiplyChunk(size_t c) {
+    const RowChunk &chunk = chunks[c];
+    Output &out = outputs[c];
+    MarkerArray &marker = tlsMarker;
+    marker.ensureSize(right.N);
+    double *acc = nullptr;
+    if constexpr (Semiring::hasValues) {
+      acc = valueAccumulator(right.N);
+    }
+
+    out.rowNnz.assign(chunk.rowEnd - chunk.rowBegin, 0);
+    for (int i = chunk.rowBegin; i < chunk.rowEnd; ++i) {
+      const uint32_t stamp = marker.next();
+      const size_t before = out.cols.size();
+      const int aBegin = std::max(left.rowPtr[i], chunk.aBegin);
+      const int aEnd = std::min(left.rowPtr[i + 1], chunk.aEnd);
+
+      // The accumulator row goes in with the first piece of the row
+      if (accum && chunk.aBegin <= left.rowPtr[i]) {
+        for (int p = accum->rowPtr[i]; p < accum->rowPtr[i + 1]; ++p) {
+          const int k = accum->colIdx[p];
+          marker.stamp[k] = stamp;
+          out.cols.push_back(k);
+          if constexpr (Semiring::hasValues) {
+            acc[k] = accum->values.empty() ? Semiring::one()
+                                           : accum->values[p];
+          }
+        }
+      }
+
+      multiplyRow<Semiring, LeftValued, RightValued>(
+          left, right, aBegin, aEnd, marker, stamp, out.cols, acc);
+      std::sort(out.cols.begin() + before, out.cols.end());
+      if constexpr (Semiring::hasValues) {
+        for (size_t p = before; p < out.cols.size(); ++p) {
+          out.vals.push_back(acc[out.cols[p]]);
+        }
+      }
+      out.rowNnz[i - chunk.rowBegin] = static_cast<int>(out.cols.size() - before);
+    }
+  }
+
+  void mergePieces(int first, int last) {
+    MarkerArray &marker = tlsMarker;
+    marker.ensureSize(right.N);
+    const uint32_t stamp = marker.next();
+    double *acc = nullptr;
+    if constexpr (Semiring::hasValues) {
+      acc = valueAccumulator(right.N);
+    }
+
+    auto &cols = outputs[first].cols;
+    for (size_t p = 0; p < cols.size(); ++p) {
+      marker.stamp[cols[p]] = stamp;
+      if constexpr (Semiring::hasValues) {
+        acc[cols[p]] = outputs[first].vals[p];
+      }
+    }
+    for (int c = first + 1; c <= last; ++c) {
+      const Output &piece = outputs[c];
+      for (size_t p = 0; p < piece.cols.size(); ++p) {
+        const int k = piece.cols[p];
+        if (marker.stamp[k] != stamp) {
+          marker.stamp[k] = stamp;
+          cols.push_back(k);
+          if constexpr (Semiring::hasValues) {
+            acc[k] = piece.vals[p];
           }
+        } else if constexpr (Semiring::hasValues) {
+          acc[k] = Semiring::add(acc[k], piece.vals[p]);
         }
       }
+      outputs[c] = Output();
     }
+    std::sort(cols.begin(), cols.end());
+    if constexpr (Semiring::hasValues) {
+      auto &vals = outputs[first].vals;
+      vals.clear();
+      for (int k : cols) {
+        vals.push_back(acc[k]);
+      }
+    }
+    outputs[first].rowNnz[0] = static_cast<int>(cols.size());
+  }
+
+  const CSRMatrix &left;
+  const CSRMatrix &right;
+  std::vector<int64_t> nnzWork;
+  int64_t totalWork = 0;
+  std::vector<RowChunk> chunks;
+  std::vector<Output> outputs;
+  std::vector<std::pair<int, int>> units; // [first, last] chunk of each unit
+  const CSRMatrix *accum;
+  CSRMatrix &result;
+};
+
+CSRMatrix CSRMatrix::parallelMatmul(const CSRMatrix &right,
+                                    int numThreads) const {
+  requireMatmulShapes(this->shape(), right.shape());
+  requirePattern("parallelMatmul", *this);
+  requirePattern("parallelMatmul", right);
+
+  CSRMatrix result;
+  parallelMultiplyInto(right, nullptr, result, numThreads);
+  return result;
+}
+
+template <typename Semiring>
+void CSRMatrix::parallelMultiplyInto(const CSRMatrix &right,
+                                     const CSRMatrix *accum, CSRMatrix &out,
+                                     int numThreads) const {
+  std::optional<WorkStealingPool> ownPool;
+  WorkStealingPool &pool = numThreads > 0 ? ownPool.emplace(numThreads)
+                                          : WorkStealingPool::shared();
+
+  RowWiseJob<Semiring> job(*this, right, out, accum);
+  job.computeWork();
+  job.partition(pool.size() * kernelThresholds().chunksPerThread);
+
+  std::vector<std::function<void()>> tasks;
+  job.addMultiplyTasks(tasks);
+  pool.runAll(tasks);
+  job.addMergeTasks(tasks);
+  pool.runAll(tasks);
+  job.addCopyTasks(tasks);
+  pool.runAll(tasks);
+}
+
+std::vector<CSRMatrix>
+CSRMatrix::batchParallelMatmul(const std::vector<CSRMatrix> &rights,
+                               int numThreads) const {
+  for (const auto &right : rights) {
+    if (this->N != right.shape().first) {
+      throw std::invalid_argument("Dimension mismatch in batchParallelMatmul");
+    }
+    requirePattern("batchParallelMatmul", right);
+  }
+  requirePattern("batchParallelMatmul", *this);
+
+  std::optional<WorkStealingPool> ownPool;
+  WorkStealingPool &pool = numThreads > 0 ? ownPool.emplace(numThreads)
+                                          : WorkStealingPool::shared();
+
+  // Jobs hold the tasks' state, so they must not move once tasks exist
+  std::vector<CSRMatrix> results(rights.size());
+  std::vector<std::unique_ptr<RowWiseJob<BooleanSemiring>>> jobs;
+  jobs.reserve(rights.size());
+  for (size_t b = 0; b < rights.size(); ++b) {
+    jobs.push_back(std::make_unique<RowWiseJob<BooleanSemiring>>(
+        *this, rights[b], results[b]));
+  }
+
+  std::vector<std::function<void()>> tasks;
+  for (auto &job : jobs) {
+    tasks.emplace_back([&job] { job->computeWork(); });
+  }
+  pool.runAll(tasks);
+
+  // Every product gets a share of the chunk budget proportional to its flops,
+  // so large right-hand matrices are split finely and small ones are not.
+  std::vector<int64_t> jobWork;
+  jobWork.reserve(jobs.size());
+  for (const auto &job : jobs) {
+    jobWork.push_back(job->flops());
+  }
+  const std::vector<int> jobChunks = allocateChunks(
+      jobWork, pool.size() * kernelThresholds().chunksPerThread);
+  for (size_t b = 0; b < jobs.size(); ++b) {
+    tasks.emplace_back([&, b] { jobs[b]->partition(jobChunks[b]); });
+  }
+  pool.runAll(tasks);
 
-    results.emplace_back(resultCoords, this->M, right.N);
+  // (batch item x row chunk) tasks share the pool in a single run
+  for (auto &job : jobs) {
+    job->addMultiplyTasks(tasks);
+  }
+  pool.runAll(tasks);
+  for (auto &job : jobs) {
+    job->addMergeTasks(tasks);
   }
+  pool.runAll(tasks);
+  for (auto &job : jobs) {
+    job->addCopyTasks(tasks);
+  }
+  pool.runAll(tasks);
   return results;
 }
 
+template <typename Semiring>
+CSRMatrix CSRMatrix::semiringMatmul(const CSRMatrix &right,
+                                    int numThreads) const {
+  requireMatmulShapes(this->shape(), right.shape());
+
+  CSRMatrix result;
+  if (numThreads == 1) {
+    result.M = this->M;
+    result.N = right.N;
+    gustavson<Semiring>(right, tlsMarker, result.rowPtr, result.colIdx,
+                        &result.values);
+  } else {
+    parallelMultiplyInto<Semiring>(right, nullptr, result, numThreads);
+  }
+  return result;
+}
+
+template CSRMatrix
+CSRMatrix::semiringMatmul<BooleanSemiring>(const CSRMatrix &, int) const;
+template CSRMatrix
+CSRMatrix::semiringMatmul<PlusTimesSemiring>(const CSRMatrix &, int) const;
+template CSRMatrix
+CSRMatrix::semiringMatmul<MinPlusSemiring>(const CSRMatrix &, int) const;
+template CSRMatrix
+CSRMatrix::semiringMatmul<MaxTimesSemiring>(const CSRMatrix &, int) const;
+
+void CSRMatrix::toCSC(std::vector<int> &colPtr, std::vector<int> &rowIdx,
+                      int numThreads, std::vector<double> *cscValues) const {
+  const int nnz = static_cast<int>(colIdx.size());
+  // Each block counts into its own N columns, so cap the blocks at nnz / N
+  // to keep that scratch within the size of the matrix itself
+  const int64_t maxBlocks = std::max<int64_t>(1, nnz / std::max(1, N));
+  const int threads = static_cast<int>(std::max<int64_t>(
+      1, std::min<int64_t>({resolveThreads(numThreads), M, maxBlocks})));
+
+  // Split the rows into one block per thread with about equal non-zeros
+  std::vector<int> rowSplit(threads + 1, M);
+  rowSplit[0] = 0;
+  for (int t = 1; t < threads; ++t) {
+    const int64_t target = static_cast<int64_t>(nnz) * t / threads;
+    rowSplit[t] = static_cast<int>(
+        std::lower_bound(rowPtr.begin(), rowPtr.end() - 1, target) -
+        rowPtr.begin());
+    rowSplit[t] = std::max(rowSplit[t], rowSplit[t - 1]);
+  }
+
+  // Count non-zeros per column within each block
+  std::vector<std::vector<int>> offsets(threads, std::vector<int>(N, 0));
+  runThreads(threads, [&](int t) {
+    auto &count = offsets[t];
+    for (int i = rowPtr[rowSplit[t]]; i < rowPtr[rowSplit[t + 1]]; ++i) {
+      count[colIdx[i]]++;
+    }
+  });
+
+  // Exclusive prefix sum in (column, block) order turns the counts into each
+  // block's first slot within every column
+  colPtr.assign(N + 1, 0);
+  int running = 0;
+  for (int j = 0; j < N; ++j) {
+    colPtr[j] = running;
+    for (int t = 0; t < threads; ++t) {
+      const int count = offsets[t][j];
+      offsets[t][j] = running;
+      running += count;
+    }
+  }
+  colPtr[N] = running;
+
+  // Blocks are in row order and visit their rows in order, so each column's
+  // row indices come out sorted
+  rowIdx.resize(nnz);
+  const bool withValues = cscValues && !values.empty();
+  if (cscValues) {
+    cscValues->resize(withValues ? nnz : 0);
+  }
+  runThreads(threads, [&](int t) {
+    auto &offset = offsets[t];
+    for (int row = rowSplit[t]; row < rowSplit[t + 1]; ++row) {
+      if (withValues) {
+        for (int i = rowPtr[row]; i < rowPtr[row + 1]; ++i) {
+          const int slot = offset[colIdx[i]]++;
+          rowIdx[slot] = row;
+          (*cscValues)[slot] = values[i];
+        }
+      } else {
+        for (int i = rowPtr[row]; i < rowPtr[row + 1]; ++i) {
+          rowIdx[offset[colIdx[i]]++] = row;
+        }
+      }
+    }
+  });
+}
+
+CSRMatrix CSRMatrix::transpose(int numThreads) const {
+  CSRMatrix result;
+  result.M = this->N;
+  result.N = this->M;
+  toCSC(result.rowPtr, result.colIdx, numThreads, &result.values);
+  return result;
+}
+
+CSRMatrix CSRMatrix::transposeMatmul(const CSRMatrix &right,
+                                     int numThreads) const {
+  if (this->M != right.M) {
+    throw std::invalid_argument("transposeMatmul dimension mismatch: "
+                                "Left rows (" +
+                                std::to_string(this->M) + ") != Right rows (" +
+                                std::to_string(right.M) + ")");
+  }
+  requirePattern("transposeMatmul", *this);
+  requirePattern("transposeMatmul", right);
+
+  // The CSR arrays of this matrix are exactly the CSC arrays of its
+  // transpose, so the outer-product kernel runs on them as they are.
+  return outerProduct(rowPtr, colIdx, this->N, right, numThreads);
+}
+
+CSRMatrix CSRMatrix::matmulTranspose(const CSRMatrix &right,
+                                     int numThreads) const {
+  if (this->N != right.N) {
+    throw std::invalid_argument("matmulTranspose dimension mismatch: "
+                                "Left cols (" +
+                                std::to_string(this->N) + ") != Right cols (" +
+                                std::to_string(right.N) + ")");
+  }
+  requirePattern("matmulTranspose", *this);
+  requirePattern("matmulTranspose", right);
+
+  // When there are no more (row of A, row of B) pairs than stored entries,
+  // intersecting sorted rows directly is cheaper than transposing B.
+  const int64_t pairs = static_cast<int64_t>(this->M) * right.M;
+  if (pairs <= static_cast<int64_t>(colIdx.size() + right.colIdx.size())) {
+    CSRMatrix result;
+    result.M = this->M;
+    result.N = right.M;
+    result.rowPtr.assign(this->M + 1, 0);
+    for (int i = 0; i < this->M; ++i) {
+      for (int j = 0; j < right.M; ++j) {
+        if (intersectsSorted(colIdx.data() + rowPtr[i],
+                             rowPtr[i + 1] - rowPtr[i],
+                             right.colIdx.data() + right.rowPtr[j],
+                             right.rowPtr[j + 1] - right.rowPtr[j])) {
+          result.colIdx.push_back(j);
+        }
+      }
+      result.rowPtr[i + 1] = toOffset(result.colIdx.size());
+    }
+    return result;
+  }
+
+  return parallelMatmul(right.transpose(numThreads), numThreads);
+}
+
+CSRMatrix CSRMatrix::symmetricMatmul(bool mirror, int numThreads) const {
+  requirePattern("symmetricMatmul", *this);
+
+  // Row j of A^T's CSR is column j of A, with its rows in increasing order
+  std::vector<int> colPtr, rowIdx;
+  toCSC(colPtr, rowIdx, numThreads);
+
+  // cscPos[p] is where non-zero p of the CSR sits in the CSC. Walking the
+  // columns in order visits each row's non-zeros in CSR order.
+  std::vector<int> cscPos(colIdx.size());
+  {
+    std::vector<int> cursor(rowPtr.begin(), rowPtr.end() - 1);
+    for (int q = 0; q < static_cast<int>(rowIdx.size()); ++q) {
+      cscPos[cursor[rowIdx[q]]++] = q;
+    }
+  }
+
+  // Row i only needs the rows j >= i of each column it touches; those start
+  // at i's own position in the column, so that suffix is the exact work.
+  std::vector<int64_t> nnzWork(colIdx.size());
+  for (size_t p = 0; p < colIdx.size(); ++p) {
+    nnzWork[p] = colPtr[colIdx[p] + 1] - cscPos[p];
+  }
+
+  std::optional<WorkStealingPool> ownPool;
+  WorkStealingPool &pool = numThreads > 0 ? ownPool.emplace(numThreads)
+                                          : WorkStealingPool::shared();
+  const std::vector<RowChunk> chunks =
+      partitionRowsByWork(rowPtr, nnzWork,
+                          pool.size() * kernelThresholds().chunksPerThread,
+                          false);
+  std::vector<int64_t>().swap(nnzWork);
+
+  std::vector<std::vector<int>> chunkCols(chunks.size());
+  CSRMatrix upper;
+  upper.M = this->M;
+  upper.N = this->M;
+  upper.rowPtr.assign(this->M + 1, 0);
+
+  std::vector<std::function<void()>> tasks;
+  for (size_t c = 0; c < chunks.size(); ++c) {
+    tasks.emplace_back([&, c] {
+      const RowChunk &chunk = chunks[c];
+      auto &cols = chunkCols[c];
+      MarkerArray &marker = tlsMarker;
+      marker.ensureSize(this->M);
+
+      for (int i = chunk.rowBegin; i < chunk.rowEnd; ++i) {
+        const uint32_t stamp = marker.next();
+        const size_t before = cols.size();
+        for (int p = rowPtr[i]; p < rowPtr[i + 1]; ++p) {
+          for (int q = cscPos[p]; q < colPtr[colIdx[p] + 1]; ++q) {
+            const int j = rowIdx[q];
+            if (marker.stamp[j] != stamp) {
+              marker.stamp[j] = stamp;
+              cols.push_back(j);
+            }
+          }
+        }
+        std::sort(cols.begin() + before, cols.end());
+        upper.rowPtr[i + 1] = static_cast<int>(cols.size() - before);
+      }
+    });
+  }
+  pool.runAll(tasks);
+
+  for (int i = 0; i < this->M; ++i) {
+    upper.rowPtr[i + 1] = toOffset(static_cast<size_t>(upper.rowPtr[i]) +
+                                   upper.rowPtr[i + 1]);
+  }
+  upper.colIdx.resize(upper.rowPtr.back());
+  for (size_t c = 0; c < chunks.size(); ++c) {
+    tasks.emplace_back([&, c] {
+      std::copy(chunkCols[c].begin(), chunkCols[c].end(),
+                upper.colIdx.begin() + upper.rowPtr[chunks[c].rowBegin]);
+    });
+  }
+  pool.runAll(tasks);
+
+  return mirror ? upper.mirrorUpperTriangle(numThreads) : upper;
+}
+
+CSRMatrix CSRMatrix::mirrorUpperTriangle(int numThreads) const {
+  if (this->M != this->N) {
+    throw std::invalid_argument("mirrorUpperTriangle: matrix must be square, "
+                                "got " +
+                                std::to_string(this->M) + "x" +
+                                std::to_string(this->N));
+  }
+  requirePattern("mirrorUpperTriangle", *this);
+
+  // Row i of the transpose holds the entries j <= i, and row i of this
+  // matrix the entries j >= i, so dropping the transpose's diagonal and
+  // appending this row keeps every full row sorted.
+  const CSRMatrix lower = transpose(numThreads);
+  CSRMatrix full;
+  full.M = this->M;
+  full.N = this->N;
+  full.rowPtr.assign(this->M + 1, 0);
+  for (int i = 0; i < this->M; ++i) {
+    int lowerLen = lower.rowPtr[i + 1] - lower.rowPtr[i];
+    if (lowerLen > 0 && lower.colIdx[lower.rowPtr[i + 1] - 1] == i) {
+      --lowerLen;
+    }
+    full.rowPtr[i + 1] = toOffset(static_cast<size_t>(full.rowPtr[i]) +
+                                  lowerLen + (rowPtr[i + 1] - rowPtr[i]));
+  }
+  full.colIdx.resize(full.rowPtr.back());
+
+  const int threads = std::max(1, std::min(resolveThreads(numThreads), M));
+  runThreads(threads, [&](int t) {
+    const int rowBegin = static_cast<int>(static_cast<int64_t>(M) * t / threads);
+    const int rowEnd =
+        static_cast<int>(static_cast<int64_t>(M) * (t + 1) / threads);
+    for (int i = rowBegin; i < rowEnd; ++i) {
+      const int lowerLen = full.rowPtr[i + 1] - full.rowPtr[i] -
+                           (rowPtr[i + 1] - rowPtr[i]);
+      auto out = full.colIdx.begin() + full.rowPtr[i];
+      out = std::copy_n(lower.colIdx.begin() + lower.rowPtr[i], lowerLen, out);
+      std::copy(colIdx.begin() + rowPtr[i], colIdx.begin() + rowPtr[i + 1],
+                out);
+    }
+  });
+  return full;
+}
+
+// Throws unless the shape is square, as powers and closures require.
+static void requireSquare(const char *name, std::pair<int, int> shape) {
+  if (shape.first != shape.second) {
+    throw std::invalid_argument(std::string(name) +
+                                ": matrix must be square, got " +
+                                std::to_string(shape.first) + "x" +
+                                std::to_string(shape.second));
+  }
+}
+
+CSRMatrix CSRMatrix::power(int k, int numThreads) const {
+  requireSquare("power", this->shape());
+  requirePattern("power", *this);
+  if (k < 0) {
+    throw std::invalid_argument("power: exponent must be non-negative, got " +
+                                std::to_string(k));
+  }
+  if (k == 0) {
+    CSRMatrix identity;
+    identity.M = this->M;
+    identity.N = this->N;
+    identity.rowPtr.resize(this->M + 1);
+    identity.colIdx.resize(this->M);
+    for (int i = 0; i < this->M; ++i) {
+      identity.rowPtr[i] = i;
+      identity.colIdx[i] = i;
+    }
+    identity.rowPtr[this->M] = this->M;
+    return identity;
+  }
+
+  SpGEMMWorkspace workspace;
+  auto multiply = [&](const CSRMatrix &left, const CSRMatrix &right,
+                      CSRMatrix &out) {
+    if (numThreads == 1) {
+      left.multiplyInto(right, out, workspace);
+    } else {
+      left.parallelMultiplyInto(right, nullptr, out, numThreads);
+    }
+  };
+
+  // base runs through this^(2^i); result collects the set bits of k. spare
+  // receives every product and then trades places with its input.
+  CSRMatrix base = *this;
+  CSRMatrix spare;
+  std::optional<CSRMatrix> result;
+  while (true) {
+    if (k & 1) {
+      if (!result) {
+        result = base;
+      } else {
+        multiply(*result, base, spare);
+        std::swap(*result, spare);
+      }
+    }
+    k >>= 1;
+    if (k == 0) {
+      break;
+    }
+
+    multiply(base, base, spare);
+    if (spare.rowPtr == base.rowPtr && spare.colIdx == base.colIdx) {
+      // base is idempotent, so the remaining bits all contribute base itself
+      if (!result) {
+        result = std::move(base);
+      } else {
+        multiply(*result, base, spare);
+        std::swap(*result, spare);
+      }
+      break;
+    }
+    std::swap(base, spare);
+  }
+  return std::move(*result);
+}
+
+CSRMatrix CSRMatrix::transitiveClosure(int numThreads) const {
+  requireSquare("transitiveClosure", this->shape());
+  requirePattern("transitiveClosure", *this);
+
+  CSRMatrix closure = *this;
+  CSRMatrix spare;
+  SpGEMMWorkspace workspace;
+  while (true) {
+    const size_t before = closure.colIdx.size();
+
+    if (numThreads == 1) {
+      closure.multiplyAccumulate(closure, closure, workspace);
+    } else {
+      // closure ∪ closure² in one pass into spare, which then becomes closure
+      closure.parallelMultiplyInto(closure, &closure, spare, numThreads);
+      std::swap(closure, spare);
+    }
+
+    if (closure.colIdx.size() == before) {
+      break;
+    }
+  }
+  return closure;
+}
+
+std::vector<int> CSRMatrix::duplicateRowRepresentatives() const {
+  std::vector<int> representative(M);
+  // Representatives by pattern hash; nextSameHash chains colliding ones
+  std::unordered_map<uint64_t, int> firstWithHash;
+  firstWithHash.reserve(M);
+  std::vector<int> nextSameHash(M, -1);
+
+  for (int i = 0; i < M; ++i) {
+    const int *row = colIdx.data() + rowPtr[i];
+    const int len = rowPtr[i + 1] - rowPtr[i];
+    uint64_t hash = 0xcbf29ce484222325ull ^ static_cast<uint64_t>(len);
+    for (int p = 0; p < len; ++p) {
+      hash = (hash ^ static_cast<uint32_t>(row[p])) * 0x100000001b3ull;
+    }
+
+    representative[i] = i;
+    auto [it, inserted] = firstWithHash.try_emplace(hash, i);
+    if (inserted) {
+      continue;
+    }
+    int candidate = it->second;
+    while (true) {
+      if (rowPtr[candidate + 1] - rowPtr[candidate] == len &&
+          std::equal(row, row + len, colIdx.data() + rowPtr[candidate])) {
+        representative[i] = candidate;
+        break;
+      }
+      if (nextSameHash[candidate] < 0) {
+        nextSameHash[candidate] = i;
+        break;
+      }
+      candidate = nextSameHash[candidate];
+    }
+  }
+  return representative;
+}
+
+CSRMatrix CSRMatrix::dedupRowsMatmul(const CSRMatrix &right,
+                                     int numThreads) const {
+  requireMatmulShapes(this->shape(), right.shape());
+  requirePattern("dedupRowsMatmul", *this);
+  requirePattern("dedupRowsMatmul", right);
+  const std::vector<int> representative = duplicateRowRepresentatives();
+
+  // Slot of every representative in the compact operand; without duplicates
+  // the plain multiply runs before anything is copied
+  std::vector<int> slot(M, -1);
+  int distinctRows = 0;
+  size_t distinctNnz = 0;
+  for (int i = 0; i < M; ++i) {
+    if (representative[i] == i) {
+      slot[i] = distinctRows++;
+      distinctNnz += rowPtr[i + 1] - rowPtr[i];
+    }
+  }
+  if (distinctRows == M) {
+    return numThreads == 1 ? naiveMatmul(right)
+                           : parallelMatmul(right, numThreads);
+  }
+
+  // Compact left operand holding one row per distinct pattern
+  CSRMatrix distinct;
+  distinct.M = distinctRows;
+  distinct.N = N;
+  distinct.rowPtr.reserve(distinctRows + 1);
+  distinct.rowPtr.push_back(0);
+  distinct.colIdx.reserve(distinctNnz);
+  for (int i = 0; i < M; ++i) {
+    if (representative[i] == i) {
+      distinct.colIdx.insert(distinct.colIdx.end(),
+                             colIdx.begin() + rowPtr[i],
+                             colIdx.begin() + rowPtr[i + 1]);
+      distinct.rowPtr.push_back(toOffset(distinct.colIdx.size()));
+    }
+  }
+
+  const CSRMatrix product = numThreads == 1
+                                ? distinct.naiveMatmul(right)
+                                : distinct.parallelMatmul(right, numThreads);
+
+  // Every row copies the product row of its representative
+  CSRMatrix result;
+  result.M = M;
+  result.N = right.N;
+  result.rowPtr.assign(M + 1, 0);
+  size_t total = 0;
+  for (int i = 0; i < M; ++i) {
+    const int s = slot[representative[i]];
+    total += product.rowPtr[s + 1] - product.rowPtr[s];
+    result.rowPtr[i + 1] = toOffset(total);
+  }
+  result.colIdx.resize(total);
+  for (int i = 0; i < M; ++i) {
+    const int s = slot[representative[i]];
+    std::copy(product.colIdx.begin() + product.rowPtr[s],
+              product.colIdx.begin() + product.rowPtr[s + 1],
+              result.colIdx.begin() + result.rowPtr[i]);
+  }
+  return result;
+}
+
+std::vector<double>
+CSRMatrix::multiplyVector(const std::vector<double> &x) const {
+  if (static_cast<int>(x.size()) != N) {
+    throw std::invalid_argument("SpMV dimension mismatch: Matrix cols (" +
+                                std::to_string(N) + ") != Vector size (" +
+                                std::to_string(x.size()) + ")");
+  }
+
+  std::vector<double> y(M, 0.0);
+  if (values.empty()) {
+    for (int i = 0; i < M; ++i) {
+      double acc = 0.0;
+      for (int p = rowPtr[i]; p < rowPtr[i + 1]; ++p) {
+        acc += x[colIdx[p]];
+      }
+      y[i] = acc;
+    }
+  } else {
+    for (int i = 0; i < M; ++i) {
+      double acc = 0.0;
+      for (int p = rowPtr[i]; p < rowPtr[i + 1]; ++p) {
+        acc += values[p] * x[colIdx[p]];
+      }
+      y[i] = acc;
+    }
+  }
+  return y;
+}
+
+CSRMatrix CSRMatrix::outerProduct(const std::vector<int> &colPtrA,
+                                  const std::vector<int> &rowIdxA, int rowsA,
+                                  const CSRMatrix &right, int numThreads,
+                                  size_t reserveHint) {
+  const int colsB = right.N;
+  const int numKeys = static_cast<int>(colPtrA.size()) - 1;
+  const int threads = resolveThreads(numThreads);
+
+  // Split the join keys into one contiguous range per thread, balanced by the
+  // number of partial products (|A col k| * |B row k|) each key generates.
+  std::vector<int64_t> keyFlops(numKeys + 1, 0);
+  for (int k = 0; k < numKeys; ++k) {
+    const int64_t lenA = colPtrA[k + 1] - colPtrA[k];
+    const int64_t lenB = right.rowPtr[k + 1] - right.rowPtr[k];
+    keyFlops[k + 1] = keyFlops[k] + lenA * lenB;
+  }
+  std::vector<int> keySplit(threads + 1, numKeys);
+  keySplit[0] = 0;
+  for (int t = 1; t < threads; ++t) {
+    const int64_t target = keyFlops.back() * t / threads;
+    keySplit[t] = static_cast<int>(
+        std::lower_bound(keyFlops.begin(), keyFlops.end(), target) -
+        keyFlops.begin());
+    keySplit[t] = std::clamp(keySplit[t], keySplit[t - 1], numKeys);
+  }
+
+  // Rows of the result are partitioned into contiguous buckets
+  const int numBuckets = std::max(1, std::min(rowsA, threads * 4));
+  const int rowsPerBucket = (rowsA + numBuckets - 1) / numBuckets;
+
+  // Expansion: partial[t][b] holds the (row, col) products thread t routed to
+  // bucket b. Every row of B is read once, for its join key.
+  std::vector<std::vector<std::vector<Coord>>> partial(
+      threads, std::vector<std::vector<Coord>>(numBuckets));
+  runThreads(threads, [&](int t) {
+    auto &buckets = partial[t];
+    for (int k = keySplit[t]; k < keySplit[t + 1]; ++k) {
+      const int bBegin = right.rowPtr[k];
+      const int bEnd = right.rowPtr[k + 1];
+      if (bBegin == bEnd) {
+        continue;
+      }
+      for (int aPos = colPtrA[k]; aPos < colPtrA[k + 1]; ++aPos) {
+        const int i = rowIdxA[aPos];
+        auto &bucket = buckets[i / rowsPerBucket];
+        for (int bPos = bBegin; bPos < bEnd; ++bPos) {
+          bucket.push_back({i, right.colIdx[bPos]});
+        }
+      }
+    }
+  });
+
+  // Merge: buckets are handed out dynamically, and each one is grouped by
+  // row, deduplicated and sorted.
+  std::vector<int> rowNnz(rowsA, 0);
+  std::vector<std::vector<int>> bucketCols(numBuckets);
+  std::atomic<int> nextBucket{0};
+  runThreads(threads, [&](int) {
+    std::vector<int> marker(colsB, -1);
+    std::vector<int> rowStart, rowOffset, grouped;
+    int b;
+    while ((b = nextBucket.fetch_add(1)) < numBuckets) {
+      const int r0 = b * rowsPerBucket;
+      const int r1 = std::min(rowsA, r0 + rowsPerBucket);
+      if (r0 >= r1) {
+        continue;
+      }
+
+      // Counting sort of the bucket's partial products by row
+      rowStart.assign(r1 - r0 + 1, 0);
+      for (int t = 0; t < threads; ++t) {
+        for (const auto &[r, c] : partial[t][b]) {
+          rowStart[r - r0 + 1]++;
+        }
+      }
+      for (int r = 0; r < r1 - r0; ++r) {
+        rowStart[r + 1] += rowStart[r];
+      }
+      rowOffset.assign(rowStart.begin(), rowStart.end() - 1);
+      grouped.resize(rowStart.back());
+      for (int t = 0; t < threads; ++t) {
+        for (const auto &[r, c] : partial[t][b]) {
+          grouped[rowOffset[r - r0]++] = c;
+        }
+        std::vector<Coord>().swap(partial[t][b]);
+      }
+
+      auto &cols = bucketCols[b];
+      cols.reserve(reserveHint / numBuckets);
+      for (int r = r0; r < r1; ++r) {
+        const size_t before = cols.size();
+        for (int p = rowStart[r - r0]; p < rowStart[r - r0 + 1]; ++p) {
+          const int c = grouped[p];
+          if (marker[c] != r) {
+            marker[c] = r;
+            cols.push_back(c);
+          }
+        }
+        std::sort(cols.begin() + before, cols.end());
+        rowNnz[r] = static_cast<int>(cols.size() - before);
+      }
+    }
+  });
+
+  CSRMatrix result;
+  result.M = rowsA;
+  result.N = colsB;
+  result.rowPtr.assign(rowsA + 1, 0);
+  for (int r = 0; r < rowsA; ++r) {
+    result.rowPtr[r + 1] =
+        toOffset(static_cast<size_t>(result.rowPtr[r]) + rowNnz[r]);
+  }
+  result.colIdx.resize(result.rowPtr.back());
+
+  // Buckets cover disjoint row ranges, so they are copied out in parallel
+  nextBucket = 0;
+  runThreads(threads, [&](int) {
+    int b;
+    while ((b = nextBucket.fetch_add(1)) < numBuckets) {
+      const int r0 = std::min(rowsA, b * rowsPerBucket);
+      std::copy(bucketCols[b].begin(), bucketCols[b].end(),
+                result.colIdx.begin() + result.rowPtr[r0]);
+    }
+  });
+
+  return result;
+}
+
 std::pair<int, int> CSRMatrix::shape() const { return {this->M, this->N}; }
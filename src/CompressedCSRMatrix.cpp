@@ -0,0 +1,193 @@
+#include "../include/CompressedCSRMatrix.h"
+#include "../include/MatrixChecks.h"
+#include "../include/SpGEMMWorkspace.h"
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+
+// Gap word announcing that the full column follows in two words.
+static constexpr uint16_t kEscape = 0xFFFF;
+
+// Per-thread column markers for kernels called without a workspace.
+static thread_local MarkerArray tlsMarker;
+
+CompressedCSRMatrix::CompressedCSRMatrix(const CSRMatrix &csr) {
+  requirePattern("CompressedCSRMatrix", csr);
+  std::tie(M, N) = csr.shape();
+  const auto &csrRowPtr = csr.getRowPtr();
+  const auto &csrColIdx = csr.getColIdx();
+  numNonZeros = csrColIdx.size();
+
+  rowPtr.assign(M + 1, 0);
+  gaps.reserve(csrColIdx.size());
+  for (int row = 0; row < M; ++row) {
+    int prev = 0;
+    for (int p = csrRowPtr[row]; p < csrRowPtr[row + 1]; ++p) {
+      const int col = csrColIdx[p];
+      const int gap = col - prev;
+      if (gap < kEscape) {
+        gaps.push_back(static_cast<uint16_t>(gap));
+      } else {
+        gaps.push_back(kEscape);
+        gaps.push_back(static_cast<uint16_t>(col >> 16));
+        gaps.push_back(static_cast<uint16_t>(col & 0xFFFF));
+      }
+      prev = col;
+    }
+    rowPtr[row + 1] = toOffset(gaps.size());
+  }
+  gaps.shrink_to_fit();
+}
+
+template <typename Fn>
+void CompressedCSRMatrix::forEachInRow(int row, Fn &&fn) const {
+  const uint16_t *word = gaps.data() + rowPtr[row];
+  const uint16_t *end = gaps.data() + rowPtr[row + 1];
+  int col = 0;
+  while (word != end) {
+    if (*word != kEscape) {
+      col += *word++;
+    } else {
+      col = (static_cast<int>(word[1]) << 16) | word[2];
+      word += 3;
+    }
+    fn(col);
+  }
+}
+
+CSRMatrix CompressedCSRMatrix::toCSR() const {
+  std::vector<int> csrRowPtr(M + 1, 0);
+  std::vector<int> csrColIdx;
+  csrColIdx.reserve(numNonZeros);
+  for (int row = 0; row < M; ++row) {
+    forEachInRow(row, [&](int col) { csrColIdx.push_back(col); });
+    csrRowPtr[row + 1] = toOffset(csrColIdx.size());
+  }
+  return CSRMatrix(std::move(csrRowPtr), std::move(csrColIdx), M, N);
+}
+
+CSRMatrix
+CompressedCSRMatrix::naiveMatmul(const CompressedCSRMatrix &right) const {
+  requireMatmulShapes(shape(), right.shape());
+
+  MarkerArray &marker = tlsMarker;
+  marker.ensureSize(right.N);
+  std::vector<int> outRowPtr(M + 1, 0);
+  std::vector<int> outColIdx;
+
+  for (int i = 0; i < M; ++i) {
+    const uint32_t stamp = marker.next();
+    forEachInRow(i, [&](int j) {
+      right.forEachInRow(j, [&](int k) {
+        if (marker.stamp[k] != stamp) {
+          marker.stamp[k] = stamp;
+          outColIdx.push_back(k);
+        }
+      });
+    });
+    std::sort(outColIdx.begin() + outRowPtr[i], outColIdx.end());
+    outRowPtr[i + 1] = toOffset(outColIdx.size());
+  }
+  return CSRMatrix(std::move(outRowPtr), std::move(outColIdx), M, right.N);
+}
+
+std::vector<double>
+CompressedCSRMatrix::multiplyVector(const std::vector<double> &x) const {
+  if (static_cast<int>(x.size()) != N) {
+    throw std::invalid_argument("SpMV dimension mismatch: Matrix cols (" +
+                                std::to_string(N) + ") != Vector size (" +
+                                std::to_string(x.size()) + ")");
+  }
+
+  std::vector<double> y(M, 0.0);
+  for (int i = 0; i < M; ++i) {
+    double acc = 0.0;
+    forEachInRow(i, [&](int col) { acc += x[col]; });
+    y[i] = acc;
+  }
+  return y;
+}
+
+std::vector<int>
+CompressedCSRMatrix::vectorMatmul(const std::vector<int> &x) const {
+  int64_t words = 0;
+  for (int i : x) {
+    if (i < 0 || i >= M) {
+      throw std::out_of_range("Vector index " + std::to_string(i) +
+                              " is out of matrix bounds.");
+    }
+    words += rowPtr[i + 1] - rowPtr[i];
+  }
+
+  // Encoded words bound the entries; past the cost of a bitmap sweep, the
+  // bitmap beats sorting the hits
+  if (words * 8 > N / 64) {
+    std::vector<uint64_t> bits((N + 63) / 64, 0);
+    for (int i : x) {
+      forEachInRow(i, [&](int col) {
+        bits[col >> 6] |= uint64_t{1} << (col & 63);
+      });
+    }
+    std::vector<int> result;
+    for (size_t w = 0; w < bits.size(); ++w) {
+      for (uint64_t word = bits[w]; word; word &= word - 1) {
+        result.push_back(static_cast<int>(w * 64) + std::countr_zero(word));
+      }
+    }
+    return result;
+  }
+
+  MarkerArray &marker = tlsMarker;
+  marker.ensureSize(N);
+  const uint32_t stamp = marker.next();
+  std::vector<int> result;
+  for (int i : x) {
+    forEachInRow(i, [&](int col) {
+      if (marker.stamp[col] != stamp) {
+        marker.stamp[col] = stamp;
+        result.push_back(col);
+      }
+    });
+  }
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+std::vector<int> CompressedCSRMatrix::bfsLevels(int source) const {
+  if (M != N) {
+    throw std::invalid_argument("BFS: adjacency must be square, got " +
+                                std::to_string(M) + "x" + std::to_string(N));
+  }
+  if (source < 0 || source >= M) {
+    throw std::out_of_range("BFS source " + std::to_string(source) +
+                            " is out of matrix bounds.");
+  }
+
+  std::vector<int> levels(M, -1);
+  std::vector<int> frontier = {source};
+  std::vector<int> next;
+  levels[source] = 0;
+  for (int level = 1; !frontier.empty(); ++level) {
+    next.clear();
+    for (int u : frontier) {
+      forEachInRow(u, [&](int v) {
+        if (levels[v] < 0) {
+          levels[v] = level;
+          next.push_back(v);
+        }
+      });
+    }
+    frontier.swap(next);
+  }
+  return levels;
+}
+
+size_t CompressedCSRMatrix::indexBytes() const {
+  return gaps.size() * sizeof(uint16_t);
+}
+
+size_t CompressedCSRMatrix::nnz() const { return numNonZeros; }
+
+std::pair<int, int> CompressedCSRMatrix::shape() const { return {M, N}; }
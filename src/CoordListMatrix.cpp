@@ -1,8 +1,33 @@
 #include "../include/CoordListMatrix.h"
 #include "../include/Estimator.h"
+#include "../include/Scheduler.h"
+#include "../include/Tuning.h"
+#include <algorithm>
 #include <fstream>
+#include <optional>
 #include <sstream>
 
+// Per-thread column markers for the pool tasks of batchParallelMatmul.
+static thread_local MarkerArray tlsMarker;
+
+// Groups coordinates by row with a counting sort, producing CSR-style row
+// pointers and the column of every entry in row order.
+static void groupByRow(const std::vector<Coord> &coords, int numRows,
+                       std::vector<int> &rowPtr, std::vector<int> &cols) {
+  rowPtr.assign(numRows + 1, 0);
+  for (const auto &[row, col] : coords) {
+    rowPtr[row + 1]++;
+  }
+  for (int i = 0; i < numRows; ++i) {
+    rowPtr[i + 1] += rowPtr[i];
+  }
+  cols.resize(coords.size());
+  std::vector<int> rowOffset(rowPtr.begin(), rowPtr.end() - 1);
+  for (const auto &[row, col] : coords) {
+    cols[rowOffset[row]++] = col;
+  }
+}
+
 CoordListMatrix::CoordListMatrix(const std::string &filename) : M(0), N(0) {
   std::ifstream fin(filename);
   if (!fin.is_open()) {
@@ -198,6 +223,85 @@ CoordListMatrix CoordListMatrix::optimizedMatmul(const CoordListMatrix &right,
   return outMatrix;
 }
 
+// Row-wise kernel behind the workspace overloads. Both operands are grouped
+// by row into the scratch buffers, and each output row is deduplicated with
+// the scratch markers and emitted in column order.
+static void multiplyGrouped(const std::vector<Coord> &left, int rowsA,
+                            const std::vector<Coord> &right, int rowsB,
+                            int colsB, SpGEMMWorkspace::ThreadScratch &scratch,
+                            std::vector<Coord> &resultCoords) {
+  groupByRow(left, rowsA, scratch.leftRowPtr, scratch.leftCols);
+  groupByRow(right, rowsB, scratch.rightRowPtr, scratch.rightCols);
+
+  auto &marker = scratch.marker;
+  auto &rowCols = scratch.colIdx;
+  marker.ensureSize(colsB);
+
+  for (int i = 0; i < rowsA; ++i) {
+    const uint32_t stamp = marker.next();
+    rowCols.clear();
+    for (int aPos = scratch.leftRowPtr[i]; aPos < scratch.leftRowPtr[i + 1];
+         ++aPos) {
+      const int j = scratch.leftCols[aPos];
+      for (int bPos = scratch.rightRowPtr[j];
+           bPos < scratch.rightRowPtr[j + 1]; ++bPos) {
+        const int k = scratch.rightCols[bPos];
+        if (marker.stamp[k] != stamp) {
+          marker.stamp[k] = stamp;
+          rowCols.push_back(k);
+        }
+      }
+    }
+    std::sort(rowCols.begin(), rowCols.end());
+    for (int k : rowCols) {
+      resultCoords.push_back({i, k});
+    }
+  }
+}
+
+CoordListMatrix
+CoordListMatrix::naiveMatmul(const CoordListMatrix &right,
+                             SpGEMMWorkspace &workspace) const {
+  // Check for matrix dimension mismatch
+  auto [rowsA, colsA] = this->shape();
+  auto [rowsB, colsB] = right.shape();
+  if (colsA != rowsB) {
+    throw std::invalid_argument("matmul dimension mismatch: "
+                                "Left cols (" +
+                                std::to_string(colsA) + ") != Right rows (" +
+                                std::to_string(rowsB) + ")");
+  }
+
+  std::vector<Coord> resultCoords;
+  multiplyGrouped(coords, rowsA, right.coords, rowsB, colsB,
+                  workspace.scratch(), resultCoords);
+
+  return {resultCoords, rowsA, colsB};
+}
+
+CoordListMatrix CoordListMatrix::optimizedMatmul(const CoordListMatrix &right,
+                                                 double estimation,
+                                                 SpGEMMWorkspace &workspace) {
+  // Check for matrix dimension mismatch
+  auto [rowsA, colsA] = this->shape();
+  auto [rowsB, colsB] = right.shape();
+  if (colsA != rowsB) {
+    throw std::invalid_argument("matmul dimension mismatch: "
+                                "Left cols (" +
+                                std::to_string(colsA) + ") != Right rows (" +
+                                std::to_string(rowsB) + ")");
+  }
+
+  // Preallocate the result coordinate vector using the externally provided
+  // estimate
+  std::vector<Coord> resultCoords;
+  resultCoords.reserve(static_cast<size_t>(estimation));
+  multiplyGrouped(coords, rowsA, right.coords, rowsB, colsB,
+                  workspace.scratch(), resultCoords);
+
+  return {resultCoords, rowsA, colsB};
+}
+
 std::vector<CoordListMatrix> CoordListMatrix::batchNaiveMatmul(
     const std::vector<CoordListMatrix> &rights) const {
   auto [rowsA, colsA] = this->shape();
@@ -278,6 +382,129 @@ std::vector<CoordListMatrix> CoordListMatrix::batchOptimizedMatmul(
   return results;
 }
 
+std::vector<CoordListMatrix> CoordListMatrix::batchParallelMatmul(
+    const std::vector<CoordListMatrix> &rights, int numThreads) const {
+  auto [rowsA, colsA] = this->shape();
+
+  // Validate all matrix dimensions first
+  for (const auto &right : rights) {
+    if (colsA != right.shape().first) {
+      throw std::invalid_argument(
+          "Dimension mismatch in parallel batch multiplication.");
+    }
+  }
+
+  std::optional<WorkStealingPool> ownPool;
+  WorkStealingPool &pool = numThreads > 0 ? ownPool.emplace(numThreads)
+                                          : WorkStealingPool::shared();
+
+  // The left operand is shared by the whole batch, so it is grouped once
+  std::vector<int> rowPtrA, colsByRowA;
+  groupByRow(coords, rowsA, rowPtrA, colsByRowA);
+
+  struct Job {
+    std::vector<int> rowPtrB, colsByRowB;
+    std::vector<int64_t> nnzWork;
+    int64_t work = 0;
+    std::vector<RowChunk> chunks;
+    std::vector<std::vector<Coord>> partial; // one coordinate list per chunk
+  };
+  std::vector<Job> jobs(rights.size());
+  std::vector<std::function<void()>> tasks;
+
+  // Group each right operand by row and weigh every left non-zero by the
+  // length of the right row it selects
+  for (size_t b = 0; b < jobs.size(); ++b) {
+    tasks.emplace_back([&, b] {
+      Job &job = jobs[b];
+      groupByRow(rights[b].coords, rights[b].M, job.rowPtrB, job.colsByRowB);
+      job.nnzWork.resize(colsByRowA.size());
+      for (size_t p = 0; p < colsByRowA.size(); ++p) {
+        const int j = colsByRowA[p];
+        job.nnzWork[p] = job.rowPtrB[j + 1] - job.rowPtrB[j];
+        job.work += job.nnzWork[p];
+      }
+    });
+  }
+  pool.runAll(tasks);
+
+  std::vector<int64_t> jobWork;
+  jobWork.reserve(jobs.size());
+  for (const auto &job : jobs) {
+    jobWork.push_back(job.work);
+  }
+  const std::vector<int> jobChunks = allocateChunks(
+      jobWork, pool.size() * kernelThresholds().chunksPerThread);
+
+  // Rows stay whole: a coordinate list has no cheap way to union row pieces
+  for (size_t b = 0; b < jobs.size(); ++b) {
+    tasks.emplace_back([&, b] {
+      Job &job = jobs[b];
+      job.chunks =
+          partitionRowsByWork(rowPtrA, job.nnzWork, jobChunks[b], false);
+      std::vector<int64_t>().swap(job.nnzWork);
+      job.partial.resize(job.chunks.size());
+    });
+  }
+  pool.runAll(tasks);
+
+  // (batch item x row chunk) tasks share the pool in a single run
+  for (size_t b = 0; b < jobs.size(); ++b) {
+    for (size_t c = 0; c < jobs[b].chunks.size(); ++c) {
+      tasks.emplace_back([&, b, c] {
+        const Job &job = jobs[b];
+        const RowChunk &chunk = job.chunks[c];
+        auto &out = jobs[b].partial[c];
+        MarkerArray &marker = tlsMarker;
+        marker.ensureSize(rights[b].N);
+
+        for (int i = chunk.rowBegin; i < chunk.rowEnd; ++i) {
+          const uint32_t stamp = marker.next();
+          for (int aPos = rowPtrA[i]; aPos < rowPtrA[i + 1]; ++aPos) {
+            const int j = colsByRowA[aPos];
+            for (int bPos = job.rowPtrB[j]; bPos < job.rowPtrB[j + 1];
+                 ++bPos) {
+              const int k = job.colsByRowB[bPos];
+              if (marker.stamp[k] != stamp) {
+                marker.stamp[k] = stamp;
+                out.push_back({i, k});
+              }
+            }
+          }
+        }
+      });
+    }
+  }
+  pool.runAll(tasks);
+
+  // Concatenate each product's chunks into its result, in input order
+  std::vector<std::optional<CoordListMatrix>> built(jobs.size());
+  for (size_t b = 0; b < jobs.size(); ++b) {
+    tasks.emplace_back([&, b] {
+      Job &job = jobs[b];
+      size_t total = 0;
+      for (const auto &part : job.partial) {
+        total += part.size();
+      }
+      std::vector<Coord> resultCoords;
+      resultCoords.reserve(total);
+      for (auto &part : job.partial) {
+        resultCoords.insert(resultCoords.end(), part.begin(), part.end());
+        std::vector<Coord>().swap(part);
+      }
+      built[b].emplace(resultCoords, rowsA, rights[b].N);
+    });
+  }
+  pool.runAll(tasks);
+
+  std::vector<CoordListMatrix> results;
+  results.reserve(built.size());
+  for (auto &result : built) {
+    results.push_back(std::move(*result));
+  }
+  return results;
+}
+
 std::pair<int, int> CoordListMatrix::shape() const {
   return {this->M, this->N};
 }
@@ -0,0 +1,149 @@
+#include "../include/DCSRMatrix.h"
+#include "../include/MatrixChecks.h"
+#include "../include/SpGEMMWorkspace.h"
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+
+// Per-thread column markers for products narrow enough to use them.
+static thread_local MarkerArray tlsMarker;
+
+DCSRMatrix::DCSRMatrix(const CSRMatrix &csr) {
+  requirePattern("DCSRMatrix", csr);
+  std::tie(M, N) = csr.shape();
+  const auto &csrRowPtr = csr.getRowPtr();
+  colIdx = csr.getColIdx();
+
+  rowPtr.push_back(0);
+  for (int row = 0; row < M; ++row) {
+    if (csrRowPtr[row + 1] != csrRowPtr[row]) {
+      rowIds.push_back(row);
+      rowPtr.push_back(csrRowPtr[row + 1]);
+    }
+  }
+}
+
+DCSRMatrix::DCSRMatrix(const std::vector<Coord> &coords, int M, int N)
+    : M(M), N(N) {
+  if (M <= 0 || N <= 0) {
+    throw std::invalid_argument("Matrix dimensions must be positive.");
+  }
+  for (const auto &[row, col] : coords) {
+    if (row < 0 || row >= M || col < 0 || col >= N) {
+      throw std::out_of_range("Coordinate is out of matrix bounds.");
+    }
+  }
+
+  std::vector<Coord> sortedCoords = coords;
+  std::sort(sortedCoords.begin(), sortedCoords.end(),
+            [](const Coord &a, const Coord &b) {
+              return a.row != b.row ? a.row < b.row : a.col < b.col;
+            });
+  sortedCoords.erase(std::unique(sortedCoords.begin(), sortedCoords.end()),
+                     sortedCoords.end());
+
+  // A new stored row starts wherever the row index changes
+  colIdx.reserve(sortedCoords.size());
+  for (const auto &[row, col] : sortedCoords) {
+    if (rowIds.empty() || rowIds.back() != row) {
+      rowIds.push_back(row);
+      rowPtr.push_back(toOffset(colIdx.size()));
+    }
+    colIdx.push_back(col);
+  }
+  rowPtr.push_back(toOffset(colIdx.size()));
+}
+
+CSRMatrix DCSRMatrix::toCSR() const {
+  std::vector<int> csrRowPtr(M + 1, 0);
+  for (size_t r = 0; r < rowIds.size(); ++r) {
+    csrRowPtr[rowIds[r] + 1] = rowPtr[r + 1] - rowPtr[r];
+  }
+  for (int row = 0; row < M; ++row) {
+    csrRowPtr[row + 1] += csrRowPtr[row];
+  }
+  return CSRMatrix(std::move(csrRowPtr), colIdx, M, N);
+}
+
+DCSRMatrix DCSRMatrix::naiveMatmul(const DCSRMatrix &right) const {
+  requireMatmulShapes(shape(), right.shape());
+
+  // Translate every column of this matrix into right's stored row index, or
+  // -1 if that row of right is empty, and total up the flops on the way
+  std::vector<int> rightRow(colIdx.size());
+  int64_t flops = 0;
+  for (size_t p = 0; p < colIdx.size(); ++p) {
+    auto it =
+        std::lower_bound(right.rowIds.begin(), right.rowIds.end(), colIdx[p]);
+    if (it != right.rowIds.end() && *it == colIdx[p]) {
+      rightRow[p] = static_cast<int>(it - right.rowIds.begin());
+      flops += right.rowPtr[rightRow[p] + 1] - right.rowPtr[rightRow[p]];
+    } else {
+      rightRow[p] = -1;
+    }
+  }
+
+  DCSRMatrix result(this->M, right.N);
+  result.rowPtr.push_back(0);
+
+  // A marker array costs one word per column of the product, which only pays
+  // off when the product does at least that much work
+  const bool useMarker = flops >= right.N;
+  if (useMarker) {
+    tlsMarker.ensureSize(right.N);
+  }
+
+  for (size_t r = 0; r < rowIds.size(); ++r) {
+    const size_t before = result.colIdx.size();
+    const uint32_t stamp = useMarker ? tlsMarker.next() : 0;
+
+    for (int p = rowPtr[r]; p < rowPtr[r + 1]; ++p) {
+      const int j = rightRow[p];
+      if (j < 0) {
+        continue;
+      }
+      for (int q = right.rowPtr[j]; q < right.rowPtr[j + 1]; ++q) {
+        const int k = right.colIdx[q];
+        if (!useMarker) {
+          result.colIdx.push_back(k);
+        } else if (tlsMarker.stamp[k] != stamp) {
+          tlsMarker.stamp[k] = stamp;
+          result.colIdx.push_back(k);
+        }
+      }
+    }
+
+    auto rowBegin = result.colIdx.begin() + before;
+    std::sort(rowBegin, result.colIdx.end());
+    if (!useMarker) {
+      result.colIdx.erase(std::unique(rowBegin, result.colIdx.end()),
+                          result.colIdx.end());
+    }
+    if (result.colIdx.size() != before) {
+      result.rowIds.push_back(rowIds[r]);
+      result.rowPtr.push_back(toOffset(result.colIdx.size()));
+    }
+  }
+  return result;
+}
+
+std::vector<Coord> DCSRMatrix::getCoords() const {
+  std::vector<Coord> coords;
+  coords.reserve(colIdx.size());
+  for (size_t r = 0; r < rowIds.size(); ++r) {
+    for (int p = rowPtr[r]; p < rowPtr[r + 1]; ++p) {
+      coords.push_back({rowIds[r], colIdx[p]});
+    }
+  }
+  return coords;
+}
+
+const std::vector<int> &DCSRMatrix::getRowIds() const { return rowIds; }
+
+const std::vector<int> &DCSRMatrix::getRowPtr() const { return rowPtr; }
+
+const std::vector<int> &DCSRMatrix::getColIdx() const { return colIdx; }
+
+std::pair<int, int> DCSRMatrix::shape() const { return {M, N}; }
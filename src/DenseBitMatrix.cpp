@@ -0,0 +1,147 @@
+#include "../include/DenseBitMatrix.h"
+#include "../include/MatrixChecks.h"
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+#include <string>
+
+// Columns of the left operand per Four Russians table.
+static constexpr int kGroupBits = 8;
+
+DenseBitMatrix::DenseBitMatrix(int M, int N)
+    : M(M), N(N), wordsPerRow((N + 63) / 64) {
+  if (M < 0 || N < 0) {
+    throw std::invalid_argument("Matrix dimensions must be non-negative.");
+  }
+  words.assign(static_cast<size_t>(M) * wordsPerRow, 0);
+}
+
+DenseBitMatrix::DenseBitMatrix(const CSRMatrix &csr)
+    : DenseBitMatrix(csr.shape().first, csr.shape().second) {
+  requirePattern("DenseBitMatrix", csr);
+  const auto &rowPtr = csr.getRowPtr();
+  const auto &colIdx = csr.getColIdx();
+  for (int row = 0; row < M; ++row) {
+    uint64_t *out = words.data() + static_cast<size_t>(row) * wordsPerRow;
+    for (int p = rowPtr[row]; p < rowPtr[row + 1]; ++p) {
+      out[colIdx[p] >> 6] |= uint64_t{1} << (colIdx[p] & 63);
+    }
+  }
+}
+
+CSRMatrix DenseBitMatrix::toCSR() const {
+  std::vector<int> rowPtr(M + 1, 0);
+  std::vector<int> colIdx;
+  // Dense products are the largest outputs, so check the total before
+  // reserving for it
+  colIdx.reserve(toOffset(nnz()));
+  for (int row = 0; row < M; ++row) {
+    const uint64_t *in = words.data() + static_cast<size_t>(row) * wordsPerRow;
+    for (int w = 0; w < wordsPerRow; ++w) {
+      for (uint64_t bits = in[w]; bits; bits &= bits - 1) {
+        colIdx.push_back(w * 64 + std::countr_zero(bits));
+      }
+    }
+    rowPtr[row + 1] = toOffset(colIdx.size());
+  }
+  return CSRMatrix(std::move(rowPtr), std::move(colIdx), M, N);
+}
+
+DenseBitMatrix DenseBitMatrix::naiveMatmul(const DenseBitMatrix &right) const {
+  requireMatmulShapes(shape(), right.shape());
+
+  DenseBitMatrix result(this->M, right.N);
+  const int outWords = right.wordsPerRow;
+  std::vector<uint64_t> table(static_cast<size_t>(1 << kGroupBits) * outWords);
+
+  for (int k0 = 0; k0 < this->N; k0 += kGroupBits) {
+    const int groupSize = std::min(kGroupBits, this->N - k0);
+
+    // table[s] = OR of right's rows k0 + i for the bits i of s, each entry
+    // built from a smaller one plus a single row
+    std::fill(table.begin(), table.begin() + outWords, 0);
+    for (int s = 1; s < (1 << groupSize); ++s) {
+      const uint64_t *smaller =
+          table.data() + static_cast<size_t>(s & (s - 1)) * outWords;
+      const uint64_t *row =
+          right.words.data() +
+          static_cast<size_t>(k0 + std::countr_zero(static_cast<unsigned>(s))) *
+              outWords;
+      uint64_t *entry = table.data() + static_cast<size_t>(s) * outWords;
+      for (int w = 0; w < outWords; ++w) {
+        entry[w] = smaller[w] | row[w];
+      }
+    }
+
+    // Group bits never straddle a word, since 64 is a multiple of 8
+    const int word = k0 >> 6;
+    const int shift = k0 & 63;
+    for (int i = 0; i < this->M; ++i) {
+      const unsigned s = static_cast<unsigned>(
+          (words[static_cast<size_t>(i) * wordsPerRow + word] >> shift) &
+          ((1u << groupSize) - 1));
+      if (s == 0) {
+        continue;
+      }
+      const uint64_t *entry = table.data() + static_cast<size_t>(s) * outWords;
+      uint64_t *out = result.words.data() + static_cast<size_t>(i) * outWords;
+      for (int w = 0; w < outWords; ++w) {
+        out[w] |= entry[w];
+      }
+    }
+  }
+  return result;
+}
+
+DenseBitMatrix DenseBitMatrix::scatterProduct(const CSRMatrix &left,
+                                              const CSRMatrix &right) {
+  requireMatmulShapes(left.shape(), right.shape());
+  requirePattern("scatterProduct", left);
+  requirePattern("scatterProduct", right);
+  const int rowsA = left.shape().first;
+  const int colsB = right.shape().second;
+  const auto &aRowPtr = left.getRowPtr();
+  const auto &aColIdx = left.getColIdx();
+  const auto &bRowPtr = right.getRowPtr();
+  const auto &bColIdx = right.getColIdx();
+
+  DenseBitMatrix result(rowsA, colsB);
+  for (int i = 0; i < rowsA; ++i) {
+    uint64_t *out =
+        result.words.data() + static_cast<size_t>(i) * result.wordsPerRow;
+    for (int aPos = aRowPtr[i]; aPos < aRowPtr[i + 1]; ++aPos) {
+      const int j = aColIdx[aPos];
+      for (int bPos = bRowPtr[j]; bPos < bRowPtr[j + 1]; ++bPos) {
+        out[bColIdx[bPos] >> 6] |= uint64_t{1} << (bColIdx[bPos] & 63);
+      }
+    }
+  }
+  return result;
+}
+
+bool DenseBitMatrix::get(int row, int col) const {
+  if (row < 0 || row >= M || col < 0 || col >= N) {
+    throw std::out_of_range("Coordinate is out of matrix bounds.");
+  }
+  return words[static_cast<size_t>(row) * wordsPerRow + (col >> 6)] >>
+             (col & 63) &
+         1;
+}
+
+void DenseBitMatrix::set(int row, int col) {
+  if (row < 0 || row >= M || col < 0 || col >= N) {
+    throw std::out_of_range("Coordinate is out of matrix bounds.");
+  }
+  words[static_cast<size_t>(row) * wordsPerRow + (col >> 6)] |= uint64_t{1}
+                                                               << (col & 63);
+}
+
+size_t DenseBitMatrix::nnz() const {
+  size_t count = 0;
+  for (uint64_t word : words) {
+    count += std::popcount(word);
+  }
+  return count;
+}
+
+std::pair<int, int> DenseBitMatrix::shape() const { return {M, N}; }
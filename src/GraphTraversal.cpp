@@ -0,0 +1,251 @@
+#include "../include/GraphTraversal.h"
+#include "../include/MatrixChecks.h"
+#include "../include/SpGEMMWorkspace.h"
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+// Direction switch thresholds from Beamer et al.: pull once the frontier's
+// out-edges exceed 1/kAlpha of the unexplored edges, and push again once the
+// frontier holds fewer than 1/kBeta of the vertices.
+static constexpr int64_t kAlpha = 14;
+static constexpr int64_t kBeta = 24;
+
+// Per-thread column markers for the push kernel.
+static thread_local MarkerArray tlsMarker;
+
+static std::vector<int> bitmapToIndices(const std::vector<uint64_t> &bits) {
+  std::vector<int> indices;
+  for (size_t w = 0; w < bits.size(); ++w) {
+    for (uint64_t word = bits[w]; word; word &= word - 1) {
+      indices.push_back(static_cast<int>(w * 64) + std::countr_zero(word));
+    }
+  }
+  return indices;
+}
+
+static void requireIndices(const std::vector<int> &x, int size) {
+  for (int i : x) {
+    if (i < 0 || i >= size) {
+      throw std::out_of_range("Vector index " + std::to_string(i) +
+                              " is out of matrix bounds.");
+    }
+  }
+}
+
+static int requireSquare(const CSRMatrix &adjacency) {
+  auto [n, cols] = adjacency.shape();
+  if (n != cols) {
+    throw std::invalid_argument("BFS: adjacency must be square, got " +
+                                std::to_string(n) + "x" + std::to_string(cols));
+  }
+  return n;
+}
+
+std::vector<int> vectorMatmul(const std::vector<int> &x,
+                              const CSRMatrix &matrix) {
+  auto [rows, cols] = matrix.shape();
+  requireIndices(x, rows);
+  requirePattern("vectorMatmul", matrix);
+  const auto &rowPtr = matrix.getRowPtr();
+  const auto &colIdx = matrix.getColIdx();
+
+  int64_t work = 0;
+  for (int i : x) {
+    work += rowPtr[i + 1] - rowPtr[i];
+  }
+
+  // Sorting k hits costs about k log k; sweeping a bitmap costs cols / 64
+  if (work * 8 > cols / 64) {
+    std::vector<uint64_t> bits((cols + 63) / 64, 0);
+    for (int i : x) {
+      for (int p = rowPtr[i]; p < rowPtr[i + 1]; ++p) {
+        bits[colIdx[p] >> 6] |= uint64_t{1} << (colIdx[p] & 63);
+      }
+    }
+    return bitmapToIndices(bits);
+  }
+
+  MarkerArray &marker = tlsMarker;
+  marker.ensureSize(cols);
+  const uint32_t stamp = marker.next();
+  std::vector<int> result;
+  for (int i : x) {
+    for (int p = rowPtr[i]; p < rowPtr[i + 1]; ++p) {
+      if (marker.stamp[colIdx[p]] != stamp) {
+        marker.stamp[colIdx[p]] = stamp;
+        result.push_back(colIdx[p]);
+      }
+    }
+  }
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+std::vector<int> matrixVectorMatmul(const CSRMatrix &matrix,
+                                    const std::vector<int> &x) {
+  auto [rows, cols] = matrix.shape();
+  requireIndices(x, cols);
+  requirePattern("matrixVectorMatmul", matrix);
+  const auto &rowPtr = matrix.getRowPtr();
+  const auto &colIdx = matrix.getColIdx();
+
+  std::vector<uint64_t> inX((cols + 63) / 64, 0);
+  for (int j : x) {
+    inX[j >> 6] |= uint64_t{1} << (j & 63);
+  }
+
+  std::vector<int> result;
+  for (int i = 0; i < rows; ++i) {
+    for (int p = rowPtr[i]; p < rowPtr[i + 1]; ++p) {
+      if (inX[colIdx[p] >> 6] >> (colIdx[p] & 63) & 1) {
+        result.push_back(i);
+        break;
+      }
+    }
+  }
+  return result;
+}
+
+std::vector<int> bfsLevels(const CSRMatrix &adjacency, int source) {
+  const int n = requireSquare(adjacency);
+  if (source < 0 || source >= n) {
+    throw std::out_of_range("BFS source " + std::to_string(source) +
+                            " is out of matrix bounds.");
+  }
+  const auto &rowPtr = adjacency.getRowPtr();
+  const auto &colIdx = adjacency.getColIdx();
+
+  std::vector<int> levels(n, -1);
+  std::vector<uint64_t> visited((n + 63) / 64, 0);
+  auto isVisited = [&](int v) { return visited[v >> 6] >> (v & 63) & 1; };
+  auto visit = [&](int v, int level) {
+    visited[v >> 6] |= uint64_t{1} << (v & 63);
+    levels[v] = level;
+  };
+
+  // In-neighbors for the pull direction, only built if a pull step happens
+  std::optional<CSRMatrix> reverse;
+
+  std::vector<int> frontier = {source};
+  std::vector<int> next;
+  visit(source, 0);
+  int64_t unexploredEdges = static_cast<int64_t>(colIdx.size());
+  bool pulling = false;
+
+  for (int level = 1; !frontier.empty(); ++level) {
+    int64_t frontierEdges = 0;
+    for (int u : frontier) {
+      frontierEdges += rowPtr[u + 1] - rowPtr[u];
+    }
+    unexploredEdges -= frontierEdges;
+
+    if (!pulling && frontierEdges * kAlpha > unexploredEdges) {
+      pulling = true;
+    } else if (pulling &&
+               static_cast<int64_t>(frontier.size()) * kBeta < n) {
+      pulling = false;
+    }
+
+    next.clear();
+    if (pulling) {
+      if (!reverse) {
+        reverse.emplace(adjacency.transpose());
+      }
+      const auto &inPtr = reverse->getRowPtr();
+      const auto &inIdx = reverse->getColIdx();
+
+      // Frontier bitmap, so each in-neighbor test is a single bit probe
+      std::vector<uint64_t> inFrontier(visited.size(), 0);
+      for (int u : frontier) {
+        inFrontier[u >> 6] |= uint64_t{1} << (u & 63);
+      }
+      for (int v = 0; v < n; ++v) {
+        if (isVisited(v)) {
+          continue;
+        }
+        for (int p = inPtr[v]; p < inPtr[v + 1]; ++p) {
+          if (inFrontier[inIdx[p] >> 6] >> (inIdx[p] & 63) & 1) {
+            next.push_back(v);
+            break;
+          }
+        }
+      }
+      for (int v : next) {
+        visit(v, level);
+      }
+    } else {
+      for (int u : frontier) {
+        for (int p = rowPtr[u]; p < rowPtr[u + 1]; ++p) {
+          const int v = colIdx[p];
+          if (!isVisited(v)) {
+            visit(v, level);
+            next.push_back(v);
+          }
+        }
+      }
+    }
+    frontier.swap(next);
+  }
+  return levels;
+}
+
+std::vector<std::vector<int>>
+multiSourceBfsLevels(const CSRMatrix &adjacency,
+                     const std::vector<int> &sources) {
+  const int n = requireSquare(adjacency);
+  requireIndices(sources, n);
+  const auto &rowPtr = adjacency.getRowPtr();
+  const auto &colIdx = adjacency.getColIdx();
+
+  std::vector<std::vector<int>> levels(sources.size(),
+                                       std::vector<int>(n, -1));
+  std::vector<uint64_t> seen(n), frontier(n), next(n);
+
+  for (size_t batch = 0; batch < sources.size(); batch += 64) {
+    const int width =
+        static_cast<int>(std::min<size_t>(64, sources.size() - batch));
+    std::fill(seen.begin(), seen.end(), 0);
+    std::fill(frontier.begin(), frontier.end(), 0);
+    for (int b = 0; b < width; ++b) {
+      const int s = sources[batch + b];
+      seen[s] |= uint64_t{1} << b;
+      frontier[s] |= uint64_t{1} << b;
+      levels[batch + b][s] = 0;
+    }
+
+    for (int level = 1;; ++level) {
+      // Every search whose bit is in frontier[u] reaches u's out-neighbors
+      std::fill(next.begin(), next.end(), 0);
+      for (int u = 0; u < n; ++u) {
+        if (frontier[u] == 0) {
+          continue;
+        }
+        for (int p = rowPtr[u]; p < rowPtr[u + 1]; ++p) {
+          next[colIdx[p]] |= frontier[u];
+        }
+      }
+
+      bool advanced = false;
+      for (int v = 0; v < n; ++v) {
+        const uint64_t fresh = next[v] & ~seen[v];
+        frontier[v] = fresh;
+        if (fresh == 0) {
+          continue;
+        }
+        advanced = true;
+        seen[v] |= fresh;
+        for (uint64_t word = fresh; word; word &= word - 1) {
+          levels[batch + std::countr_zero(word)][v] = level;
+        }
+      }
+      if (!advanced) {
+        break;
+      }
+    }
+  }
+  return levels;
+}
@@ -0,0 +1,288 @@
+#include "../include/ProductPlanner.h"
+#include "../include/CoordListMatrix.h"
+#include "../include/Estimator.h"
+#include "../include/MatrixChecks.h"
+#include "../include/Tuning.h"
+#include <algorithm>
+#include <bit>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+
+// Plan log sink, empty unless a caller opts in; guarded for setPlanLogger()
+// racing with multiply() on other threads.
+static std::mutex planLoggerMutex;
+static std::function<void(const std::string &)> planLogger;
+
+ProductFormat chooseProductFormat(double estimate, int rows, int cols) {
+  const double cells = static_cast<double>(rows) * cols;
+  if (cells <= 0) {
+    return ProductFormat::CSR;
+  }
+  // Density decides first: a tall, narrow product can have fewer entries
+  // than rows and still be dense
+  const double density = estimate / cells;
+  const KernelThresholds &thresholds = kernelThresholds();
+  if (density >= thresholds.denseProductDensity) {
+    return ProductFormat::Dense;
+  }
+  if (density >= thresholds.bitmapRowDensity) {
+    return ProductFormat::BitmapRows;
+  }
+  if (estimate < rows) {
+    return ProductFormat::Hypersparse;
+  }
+  return ProductFormat::CSR;
+}
+
+const char *toString(ProductFormat format) {
+  switch (format) {
+  case ProductFormat::CSR:
+    return "csr";
+  case ProductFormat::Hypersparse:
+    return "hypersparse";
+  case ProductFormat::BitmapRows:
+    return "bitmap-rows";
+  case ProductFormat::Dense:
+    return "dense";
+  }
+  return "unknown";
+}
+
+// Memory the bit-packed operands may take, as a multiple of their CSR form.
+static constexpr int64_t kMaxDenseOperandBlowup = 8;
+
+// Whether bit-packing both operands stays within kMaxDenseOperandBlowup of
+// their CSR storage. A long inner dimension makes even a dense product's
+// operands sparse, and packing them would then dwarf the matrices.
+static bool denseOperandsFit(const CSRMatrix &left, const CSRMatrix &right) {
+  auto [rows, inner] = left.shape();
+  const int cols = right.shape().second;
+  auto words = [](int64_t bits) { return (bits + 63) / 64; };
+  const double denseBytes =
+      8.0 * (static_cast<double>(rows) * words(inner) +
+             static_cast<double>(inner) * words(cols));
+  const double csrBytes =
+      4.0 * (static_cast<double>(left.getColIdx().size()) +
+             right.getColIdx().size() + rows + inner + 2);
+  return denseBytes <= kMaxDenseOperandBlowup * csrBytes;
+}
+
+ProductMatrix multiplyAs(const CSRMatrix &left, const CSRMatrix &right,
+                         ProductFormat format) {
+  requireMatmulShapes(left.shape(), right.shape());
+  requirePattern("multiplyAs", left);
+  requirePattern("multiplyAs", right);
+
+  switch (format) {
+  case ProductFormat::Hypersparse:
+    return DCSRMatrix(left).naiveMatmul(DCSRMatrix(right));
+  case ProductFormat::BitmapRows:
+    return DenseBitMatrix::scatterProduct(left, right);
+  case ProductFormat::Dense:
+    if (!denseOperandsFit(left, right)) {
+      return DenseBitMatrix::scatterProduct(left, right);
+    }
+    return DenseBitMatrix(left).naiveMatmul(DenseBitMatrix(right));
+  case ProductFormat::CSR:
+    break;
+  }
+  return left.naiveMatmul(right);
+}
+
+ProductMatrix multiplyToEstimatedFormat(const CSRMatrix &left,
+                                        const CSRMatrix &right,
+                                        double estimate) {
+  return multiplyAs(
+      left, right,
+      chooseProductFormat(estimate, left.shape().first, right.shape().second));
+}
+
+CSRMatrix toCSR(const ProductMatrix &product) {
+  if (const auto *csr = std::get_if<CSRMatrix>(&product)) {
+    return *csr;
+  }
+  if (const auto *dcsr = std::get_if<DCSRMatrix>(&product)) {
+    return dcsr->toCSR();
+  }
+  return std::get<DenseBitMatrix>(product).toCSR();
+}
+
+ProductStats gatherProductStats(const CSRMatrix &left, const CSRMatrix &right,
+                                double epsilon) {
+  requireMatmulShapes(left.shape(), right.shape());
+  ProductStats stats;
+  std::tie(stats.rows, stats.inner) = left.shape();
+  stats.cols = right.shape().second;
+  const auto &aRowPtr = left.getRowPtr();
+  const auto &aColIdx = left.getColIdx();
+  const auto &bRowPtr = right.getRowPtr();
+  stats.nnzA = static_cast<int64_t>(aColIdx.size());
+  stats.nnzB = static_cast<int64_t>(right.getColIdx().size());
+
+  for (int i = 0; i < stats.rows; ++i) {
+    const int length = aRowPtr[i + 1] - aRowPtr[i];
+    const size_t bucket = std::bit_width(static_cast<unsigned>(length));
+    if (stats.rowLengthHistogram.size() <= bucket) {
+      stats.rowLengthHistogram.resize(bucket + 1, 0);
+    }
+    stats.rowLengthHistogram[bucket]++;
+
+    int64_t rowFlops = 0;
+    for (int p = aRowPtr[i]; p < aRowPtr[i + 1]; ++p) {
+      rowFlops += bRowPtr[aColIdx[p] + 1] - bRowPtr[aColIdx[p]];
+    }
+    stats.flops += rowFlops;
+    stats.maxRowFlops = std::max(stats.maxRowFlops, rowFlops);
+  }
+
+  if (stats.flops > 0) {
+    CoordListMatrix forEstimateA(left.getCoords(), stats.rows, stats.inner);
+    CoordListMatrix forEstimateB(right.getCoords(), stats.inner, stats.cols);
+    stats.estimatedNnz =
+        estimateProductSize(forEstimateA.getHashedCoords(),
+                            forEstimateB.getHashedCoords(), epsilon);
+    // The product can hold neither more entries than flops nor than cells
+    stats.estimatedNnz =
+        std::clamp(stats.estimatedNnz, 1.0,
+                   std::min(static_cast<double>(stats.flops),
+                            static_cast<double>(stats.rows) * stats.cols));
+    stats.compressionRatio = stats.flops / stats.estimatedNnz;
+  }
+  return stats;
+}
+
+// Threads for a CSR product of the given flops: one per flopsPerThread, up
+// to hardware concurrency.
+static int threadsForFlops(int64_t flops) {
+  const int64_t hardware =
+      std::max(1u, std::thread::hardware_concurrency());
+  return static_cast<int>(std::clamp<int64_t>(
+      flops / kernelThresholds().flopsPerThread, 1, hardware));
+}
+
+// Gustavson's flop count of left × right, without the other statistics.
+static int64_t countFlops(const CSRMatrix &left, const CSRMatrix &right) {
+  const auto &aColIdx = left.getColIdx();
+  const auto &bRowPtr = right.getRowPtr();
+  int64_t flops = 0;
+  for (int j : aColIdx) {
+    flops += bRowPtr[j + 1] - bRowPtr[j];
+  }
+  return flops;
+}
+
+Plan planProduct(const ProductStats &stats, int numThreads) {
+  Plan plan;
+  plan.numThreads = 1;
+
+  switch (chooseProductFormat(stats.estimatedNnz, stats.rows, stats.cols)) {
+  case ProductFormat::Hypersparse:
+    plan.kernel = Kernel::Hypersparse;
+    return plan;
+  case ProductFormat::BitmapRows:
+    plan.kernel = Kernel::BitmapRows;
+    return plan;
+  case ProductFormat::Dense:
+    plan.kernel = Kernel::Dense;
+    return plan;
+  case ProductFormat::CSR:
+    break;
+  }
+
+  const KernelThresholds &thresholds = kernelThresholds();
+  plan.numThreads = numThreads > 0 ? numThreads : threadsForFlops(stats.flops);
+  if (plan.numThreads == 1) {
+    plan.kernel = Kernel::Gustavson;
+  } else if (stats.compressionRatio <= thresholds.outerProductCompression) {
+    plan.kernel = Kernel::OuterProduct;
+  } else {
+    plan.kernel = Kernel::ParallelRowWise;
+  }
+  return plan;
+}
+
+const char *toString(Kernel kernel) {
+  switch (kernel) {
+  case Kernel::Auto:
+    return "auto";
+  case Kernel::Gustavson:
+    return "gustavson";
+  case Kernel::ParallelRowWise:
+    return "parallel-row-wise";
+  case Kernel::OuterProduct:
+    return "outer-product";
+  case Kernel::Hypersparse:
+    return "hypersparse";
+  case Kernel::BitmapRows:
+    return "bitmap-rows";
+  case Kernel::Dense:
+    return "dense";
+  }
+  return "unknown";
+}
+
+void setPlanLogger(std::function<void(const std::string &)> logger) {
+  std::lock_guard<std::mutex> lock(planLoggerMutex);
+  planLogger = std::move(logger);
+}
+
+ProductMatrix multiply(const CSRMatrix &left, const CSRMatrix &right,
+                       Plan plan) {
+  requireMatmulShapes(left.shape(), right.shape());
+  requirePattern("multiply", left);
+  requirePattern("multiply", right);
+  std::function<void(const std::string &)> logger;
+  {
+    std::lock_guard<std::mutex> lock(planLoggerMutex);
+    logger = planLogger;
+  }
+
+  std::ostringstream line;
+  line << "multiply " << left.shape().first << "x" << left.shape().second
+       << " * " << right.shape().first << "x" << right.shape().second << ": ";
+  if (plan.kernel == Kernel::Auto) {
+    const ProductStats stats = gatherProductStats(left, right);
+    plan = planProduct(stats, plan.numThreads);
+    line << "flops=" << stats.flops << " maxRowFlops=" << stats.maxRowFlops
+         << " estNnz=" << static_cast<int64_t>(stats.estimatedNnz)
+         << " compression=" << stats.compressionRatio << " rowLengths=[";
+    for (size_t b = 0; b < stats.rowLengthHistogram.size(); ++b) {
+      line << (b ? " " : "") << stats.rowLengthHistogram[b];
+    }
+    line << "] -> ";
+  } else {
+    // Only the CSR kernels besides Gustavson's run on several threads
+    if (plan.kernel != Kernel::ParallelRowWise &&
+        plan.kernel != Kernel::OuterProduct) {
+      plan.numThreads = 1;
+    } else if (plan.numThreads <= 0) {
+      plan.numThreads = threadsForFlops(countFlops(left, right));
+    }
+    line << "explicit -> ";
+  }
+  line << toString(plan.kernel) << " threads=" << plan.numThreads;
+  if (logger) {
+    logger(line.str());
+  }
+
+  switch (plan.kernel) {
+  case Kernel::ParallelRowWise:
+    return left.parallelMatmul(right, plan.numThreads);
+  case Kernel::OuterProduct:
+    return left.outerProductMatmul(right, plan.numThreads);
+  case Kernel::Hypersparse:
+    return multiplyAs(left, right, ProductFormat::Hypersparse);
+  case Kernel::BitmapRows:
+    return multiplyAs(left, right, ProductFormat::BitmapRows);
+  case Kernel::Dense:
+    return multiplyAs(left, right, ProductFormat::Dense);
+  case Kernel::Auto:
+  case Kernel::Gustavson:
+    break;
+  }
+  return left.naiveMatmul(right);
+}
@@ -0,0 +1,341 @@
+#include "../include/Reordering.h"
+#include "../include/MatrixChecks.h"
+#include "../include/Scheduler.h"
+#include "../include/Tuning.h"
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+static void requireSquare(const char *name, const CSRMatrix &A) {
+  auto [rows, cols] = A.shape();
+  if (rows != cols) {
+    throw std::invalid_argument(std::string(name) +
+                                ": matrix must be square, got " +
+                                std::to_string(rows) + "x" +
+                                std::to_string(cols));
+  }
+}
+
+// Pattern of A ∪ A^T without self loops, as sorted adjacency lists.
+static void symmetrize(const CSRMatrix &A, std::vector<int> &adjPtr,
+                       std::vector<int> &adjIdx) {
+  const int n = A.shape().first;
+  const CSRMatrix At = A.transpose(1);
+  const auto &rowPtr = A.getRowPtr();
+  const auto &colIdx = A.getColIdx();
+  const auto &tRowPtr = At.getRowPtr();
+  const auto &tColIdx = At.getColIdx();
+
+  adjPtr.assign(n + 1, 0);
+  adjIdx.clear();
+  adjIdx.reserve(2 * colIdx.size());
+  for (int u = 0; u < n; ++u) {
+    const size_t begin = adjIdx.size();
+    std::set_union(colIdx.begin() + rowPtr[u], colIdx.begin() + rowPtr[u + 1],
+                   tColIdx.begin() + tRowPtr[u],
+                   tColIdx.begin() + tRowPtr[u + 1],
+                   std::back_inserter(adjIdx));
+    adjIdx.erase(std::remove(adjIdx.begin() + begin, adjIdx.end(), u),
+                 adjIdx.end());
+    adjPtr[u + 1] = static_cast<int>(adjIdx.size());
+  }
+}
+
+// Breadth-first search from start over unreached vertices (dist < 0).
+// Returns a minimum-degree vertex of the last level and sets its distance
+// from start; dist is restored to -1 on every vertex reached.
+static int farthestVertex(const std::vector<int> &adjPtr,
+                          const std::vector<int> &adjIdx, int start,
+                          std::vector<int> &dist, std::vector<int> &queue,
+                          int &eccentricity) {
+  queue.assign(1, start);
+  dist[start] = 0;
+  for (size_t head = 0; head < queue.size(); ++head) {
+    const int u = queue[head];
+    for (int p = adjPtr[u]; p < adjPtr[u + 1]; ++p) {
+      if (dist[adjIdx[p]] < 0) {
+        dist[adjIdx[p]] = dist[u] + 1;
+        queue.push_back(adjIdx[p]);
+      }
+    }
+  }
+
+  eccentricity = dist[queue.back()];
+  auto degree = [&](int v) { return adjPtr[v + 1] - adjPtr[v]; };
+  int best = queue.back();
+  for (size_t i = queue.size(); i-- > 0 && dist[queue[i]] == eccentricity;) {
+    if (degree(queue[i]) <= degree(best)) {
+      best = queue[i];
+    }
+  }
+  for (int v : queue) {
+    dist[v] = -1;
+  }
+  return best;
+}
+
+std::vector<int> reverseCuthillMcKee(const CSRMatrix &A) {
+  requireSquare("reverseCuthillMcKee", A);
+  const int n = A.shape().first;
+  std::vector<int> adjPtr, adjIdx;
+  symmetrize(A, adjPtr, adjIdx);
+  auto degree = [&](int v) { return adjPtr[v + 1] - adjPtr[v]; };
+  auto byDegree = [&](int u, int v) {
+    return degree(u) != degree(v) ? degree(u) < degree(v) : u < v;
+  };
+
+  // Components are entered from their lowest-degree vertex
+  std::vector<int> roots(n);
+  std::iota(roots.begin(), roots.end(), 0);
+  std::sort(roots.begin(), roots.end(), byDegree);
+
+  std::vector<int> order;
+  order.reserve(n);
+  std::vector<char> visited(n, 0);
+  std::vector<int> dist(n, -1), queue;
+  for (int root : roots) {
+    if (visited[root]) {
+      continue;
+    }
+
+    // George-Liu: move to the far end of the component while that
+    // lengthens the BFS level structure
+    int start = root;
+    int eccentricity;
+    int candidate =
+        farthestVertex(adjPtr, adjIdx, start, dist, queue, eccentricity);
+    for (;;) {
+      int candidateEccentricity;
+      const int next = farthestVertex(adjPtr, adjIdx, candidate, dist, queue,
+                                      candidateEccentricity);
+      if (candidateEccentricity <= eccentricity) {
+        break;
+      }
+      start = candidate;
+      eccentricity = candidateEccentricity;
+      candidate = next;
+    }
+
+    // Cuthill-McKee: BFS enqueuing each vertex's new neighbors by degree
+    visited[start] = 1;
+    order.push_back(start);
+    for (size_t head = order.size() - 1; head < order.size(); ++head) {
+      const int u = order[head];
+      const size_t first = order.size();
+      for (int p = adjPtr[u]; p < adjPtr[u + 1]; ++p) {
+        if (!visited[adjIdx[p]]) {
+          visited[adjIdx[p]] = 1;
+          order.push_back(adjIdx[p]);
+        }
+      }
+      std::sort(order.begin() + first, order.end(), byDegree);
+    }
+  }
+  std::reverse(order.begin(), order.end());
+  return order;
+}
+
+std::vector<int> degreeOrder(const CSRMatrix &A) {
+  const auto &rowPtr = A.getRowPtr();
+  std::vector<int> order(A.shape().first);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](int u, int v) {
+    return rowPtr[u + 1] - rowPtr[u] > rowPtr[v + 1] - rowPtr[v];
+  });
+  return order;
+}
+
+std::vector<int> clusterOrder(const CSRMatrix &A, int maxRounds) {
+  requireSquare("clusterOrder", A);
+  const int n = A.shape().first;
+  std::vector<int> adjPtr, adjIdx;
+  symmetrize(A, adjPtr, adjIdx);
+
+  std::vector<int> label(n);
+  std::iota(label.begin(), label.end(), 0);
+  std::vector<int> count(n, 0), seen;
+  for (int round = 0; round < maxRounds; ++round) {
+    bool moved = false;
+    for (int u = 0; u < n; ++u) {
+      if (adjPtr[u] == adjPtr[u + 1]) {
+        continue;
+      }
+      seen.clear();
+      for (int p = adjPtr[u]; p < adjPtr[u + 1]; ++p) {
+        if (count[label[adjIdx[p]]]++ == 0) {
+          seen.push_back(label[adjIdx[p]]);
+        }
+      }
+      int best = seen.front();
+      for (int l : seen) {
+        if (count[l] > count[best] || (count[l] == count[best] && l < best)) {
+          best = l;
+        }
+      }
+      for (int l : seen) {
+        count[l] = 0;
+      }
+      if (best != label[u]) {
+        label[u] = best;
+        moved = true;
+      }
+    }
+    if (!moved) {
+      break;
+    }
+  }
+
+  // Lay clusters out by their first vertex, members in original order
+  std::vector<int> firstOf(n, n);
+  for (int u = 0; u < n; ++u) {
+    firstOf[label[u]] = std::min(firstOf[label[u]], u);
+  }
+  std::vector<int> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](int u, int v) {
+    return firstOf[label[u]] < firstOf[label[v]];
+  });
+  return order;
+}
+
+std::vector<int> invertPermutation(const std::vector<int> &perm) {
+  const int n = static_cast<int>(perm.size());
+  std::vector<int> inverse(n, -1);
+  for (int i = 0; i < n; ++i) {
+    if (perm[i] < 0 || perm[i] >= n || inverse[perm[i]] != -1) {
+      throw std::invalid_argument("invertPermutation: entry " +
+                                  std::to_string(i) + " (" +
+                                  std::to_string(perm[i]) +
+                                  ") breaks the permutation");
+    }
+    inverse[perm[i]] = i;
+  }
+  return inverse;
+}
+
+CSRMatrix permute(const CSRMatrix &A, const std::vector<int> &rowPerm,
+                  const std::vector<int> &colPerm, int numThreads) {
+  auto [M, N] = A.shape();
+  if (static_cast<int>(rowPerm.size()) != M ||
+      (!colPerm.empty() && static_cast<int>(colPerm.size()) != N)) {
+    throw std::invalid_argument(
+        "permute: permutation sizes (" + std::to_string(rowPerm.size()) +
+        ", " + std::to_string(colPerm.size()) + ") do not match " +
+        std::to_string(M) + "x" + std::to_string(N));
+  }
+  invertPermutation(rowPerm);
+  const std::vector<int> newCol =
+      colPerm.empty() ? std::vector<int>() : invertPermutation(colPerm);
+
+  const auto &rowPtr = A.getRowPtr();
+  const auto &colIdx = A.getColIdx();
+  const auto &values = A.getValues();
+  const bool hasValues = !values.empty();
+
+  std::vector<int> outPtr(M + 1, 0);
+  for (int i = 0; i < M; ++i) {
+    outPtr[i + 1] = outPtr[i] + rowPtr[rowPerm[i] + 1] - rowPtr[rowPerm[i]];
+  }
+  std::vector<int> outIdx(colIdx.size());
+  std::vector<double> outVal(values.size());
+
+  std::optional<WorkStealingPool> ownPool;
+  WorkStealingPool &pool = numThreads > 0 ? ownPool.emplace(numThreads)
+                                          : WorkStealingPool::shared();
+
+  // Row blocks of roughly equal non-zeros, cut on the output's rowPtr
+  const int numBlocks = std::max(
+      1, std::min(M, static_cast<int>(pool.size()) *
+                         kernelThresholds().chunksPerThread));
+  const int64_t nnz = static_cast<int64_t>(outIdx.size());
+  std::vector<std::function<void()>> tasks;
+  int blockBegin = 0;
+  for (int b = 1; b <= numBlocks; ++b) {
+    const int target = static_cast<int>(nnz * b / numBlocks);
+    const int blockEnd =
+        b == numBlocks ? M
+                       : static_cast<int>(
+                             std::upper_bound(outPtr.begin() + blockBegin,
+                                              outPtr.end() - 1, target) -
+                             outPtr.begin());
+    if (blockEnd <= blockBegin) {
+      continue;
+    }
+    tasks.emplace_back([&, blockBegin, blockEnd] {
+      std::vector<std::pair<int, double>> entries;
+      for (int i = blockBegin; i < blockEnd; ++i) {
+        const int src = rowPtr[rowPerm[i]];
+        const int len = outPtr[i + 1] - outPtr[i];
+        int *cols = outIdx.data() + outPtr[i];
+        if (newCol.empty()) {
+          std::copy_n(colIdx.data() + src, len, cols);
+          if (hasValues) {
+            std::copy_n(values.data() + src, len, outVal.data() + outPtr[i]);
+          }
+        } else if (!hasValues) {
+          for (int p = 0; p < len; ++p) {
+            cols[p] = newCol[colIdx[src + p]];
+          }
+          std::sort(cols, cols + len);
+        } else {
+          entries.clear();
+          for (int p = 0; p < len; ++p) {
+            entries.emplace_back(newCol[colIdx[src + p]], values[src + p]);
+          }
+          std::sort(entries.begin(), entries.end());
+          for (int p = 0; p < len; ++p) {
+            cols[p] = entries[p].first;
+            outVal[outPtr[i] + p] = entries[p].second;
+          }
+        }
+      }
+    });
+    blockBegin = blockEnd;
+  }
+  pool.runAll(tasks);
+
+  if (hasValues) {
+    return CSRMatrix(std::move(outPtr), std::move(outIdx), std::move(outVal),
+                     M, N);
+  }
+  return CSRMatrix(std::move(outPtr), std::move(outIdx), M, N);
+}
+
+CSRMatrix permuteSymmetric(const CSRMatrix &A, const std::vector<int> &perm,
+                           int numThreads) {
+  requireSquare("permuteSymmetric", A);
+  return permute(A, perm, perm, numThreads);
+}
+
+CSRMatrix reorderedMatmul(const CSRMatrix &left, const CSRMatrix &right,
+                          const std::vector<int> &perm, int numThreads,
+                          bool restoreOrder) {
+  requireMatmulShapes(left.shape(), right.shape());
+  auto [M, K] = left.shape();
+
+  // A square left operand shares one index space between its rows and the
+  // inner dimension, so the same labels carry over to right's rows
+  const bool relabelInner = M == K;
+  const CSRMatrix permutedLeft =
+      permute(left, perm, relabelInner ? perm : std::vector<int>(),
+              numThreads);
+  std::optional<CSRMatrix> permutedRight;
+  if (relabelInner) {
+    permutedRight.emplace(permute(right, perm, {}, numThreads));
+  }
+  const CSRMatrix &rightOperand = relabelInner ? *permutedRight : right;
+
+  CSRMatrix product = numThreads == 1
+                          ? permutedLeft.naiveMatmul(rightOperand)
+                          : permutedLeft.parallelMatmul(rightOperand,
+                                                        numThreads);
+  if (!restoreOrder) {
+    return product;
+  }
+  return permute(product, invertPermutation(perm), {}, numThreads);
+}
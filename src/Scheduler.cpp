@@ -0,0 +1,226 @@
+#include "../include/Scheduler.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <stdexcept>
+
+std::vector<RowChunk> partitionRowsByWork(const std::vector<int> &rowPtr,
+                                          const std::vector<int64_t> &nnzWork,
+                                          int numChunks, bool splitHeavyRows) {
+  if (rowPtr.empty() ||
+      static_cast<int64_t>(nnzWork.size()) != rowPtr.back()) {
+    throw std::invalid_argument(
+        "partitionRowsByWork: nnzWork size must equal the number of non-zeros");
+  }
+
+  const int rows = static_cast<int>(rowPtr.size()) - 1;
+  int64_t totalWork = 0;
+  for (int64_t w : nnzWork) {
+    totalWork += w;
+  }
+  const int64_t target =
+      std::max<int64_t>(1, (totalWork + numChunks - 1) / std::max(1, numChunks));
+
+  std::vector<RowChunk> chunks;
+  chunks.reserve(numChunks + 1);
+
+  int start = 0;
+  int64_t acc = 0;
+  auto flush = [&](int end) {
+    if (start < end) {
+      chunks.push_back({start, end, rowPtr[start], rowPtr[end], false});
+    }
+    start = end;
+    acc = 0;
+  };
+
+  for (int r = 0; r < rows; ++r) {
+    int64_t rowWork = 0;
+    for (int p = rowPtr[r]; p < rowPtr[r + 1]; ++p) {
+      rowWork += nnzWork[p];
+    }
+
+    if (splitHeavyRows && rowWork > target) {
+      // Heavy row: give it its own chunks, cut along its non-zeros
+      flush(r);
+      const size_t firstPiece = chunks.size();
+      int pieceBegin = rowPtr[r];
+      int64_t pieceWork = 0;
+      for (int p = rowPtr[r]; p < rowPtr[r + 1]; ++p) {
+        pieceWork += nnzWork[p];
+        if (pieceWork >= target && p + 1 < rowPtr[r + 1]) {
+          chunks.push_back({r, r + 1, pieceBegin, p + 1, true});
+          pieceBegin = p + 1;
+          pieceWork = 0;
+        }
+      }
+      chunks.push_back({r, r + 1, pieceBegin, rowPtr[r + 1], true});
+      if (chunks.size() - firstPiece == 1) {
+        chunks.back().partialRow = false;
+      }
+      start = r + 1;
+      continue;
+    }
+
+    if (acc > 0 && acc + rowWork > target) {
+      flush(r);
+    }
+    acc += rowWork;
+  }
+  flush(rows);
+
+  return chunks;
+}
+
+std::vector<int> allocateChunks(const std::vector<int64_t> &jobWork,
+                                int totalChunks) {
+  int64_t totalWork = 0;
+  for (int64_t w : jobWork) {
+    totalWork += w;
+  }
+
+  std::vector<int> chunks(jobWork.size(), 1);
+  if (totalWork == 0) {
+    return chunks;
+  }
+  for (size_t i = 0; i < jobWork.size(); ++i) {
+    const int64_t share = jobWork[i] * totalChunks / totalWork;
+    chunks[i] = static_cast<int>(std::max<int64_t>(1, share));
+  }
+  return chunks;
+}
+
+WorkStealingPool::WorkStealingPool(int numThreads) {
+  if (numThreads <= 0) {
+    numThreads =
+        static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+  }
+
+  // Queue 0 is fed to callers of runAll(); queue i belongs to worker i.
+  queues.reserve(numThreads);
+  for (int i = 0; i < numThreads; ++i) {
+    queues.push_back(std::make_unique<Queue>());
+  }
+  workers.reserve(numThreads - 1);
+  for (int i = 1; i < numThreads; ++i) {
+    workers.emplace_back(&WorkStealingPool::workerLoop, this, i);
+  }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+  {
+    std::lock_guard lock(sleepMutex);
+    stopping = true;
+  }
+  wake.notify_all();
+  for (auto &worker : workers) {
+    worker.join();
+  }
+}
+
+int WorkStealingPool::size() const { return static_cast<int>(queues.size()); }
+
+WorkStealingPool &WorkStealingPool::shared() {
+  static WorkStealingPool pool;
+  return pool;
+}
+
+bool WorkStealingPool::tryRun(int self) {
+  std::function<void()> task;
+  const int n = static_cast<int>(queues.size());
+
+  // Own deque from the back (most recently dealt), others from the front
+  for (int i = 0; i < n && !task; ++i) {
+    Queue &queue = *queues[(self + i) % n];
+    std::lock_guard lock(queue.mutex);
+    if (queue.tasks.empty()) {
+      continue;
+    }
+    if (i == 0) {
+      task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+    } else {
+      task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+    }
+  }
+  if (!task) {
+    return false;
+  }
+
+  {
+    std::lock_guard lock(sleepMutex);
+    --pending;
+  }
+  task();
+  return true;
+}
+
+void WorkStealingPool::workerLoop(int self) {
+  while (true) {
+    if (tryRun(self)) {
+      continue;
+    }
+    std::unique_lock lock(sleepMutex);
+    wake.wait(lock, [&] { return stopping || pending > 0; });
+    if (stopping && pending == 0) {
+      return;
+    }
+  }
+}
+
+void WorkStealingPool::runAll(std::vector<std::function<void()>> &tasks) {
+  if (tasks.empty()) {
+    return;
+  }
+
+  struct Batch {
+    std::atomic<size_t> remaining;
+    std::mutex mutex;
+    std::condition_variable done;
+    std::exception_ptr error;
+  };
+  auto batch = std::make_shared<Batch>();
+  batch->remaining = tasks.size();
+
+  const size_t n = queues.size();
+  for (size_t i = 0; i < tasks.size(); ++i) {
+    auto wrapped = [batch, task = std::move(tasks[i])] {
+      try {
+        task();
+      } catch (...) {
+        std::lock_guard lock(batch->mutex);
+        if (!batch->error) {
+          batch->error = std::current_exception();
+        }
+      }
+      if (batch->remaining.fetch_sub(1) == 1) {
+        std::lock_guard lock(batch->mutex);
+        batch->done.notify_all();
+      }
+    };
+    Queue &queue = *queues[i % n];
+    std::lock_guard lock(queue.mutex);
+    queue.tasks.push_back(std::move(wrapped));
+  }
+  {
+    std::lock_guard lock(sleepMutex);
+    pending += static_cast<int64_t>(tasks.size());
+  }
+  wake.notify_all();
+
+  // The caller works through the queues too, until its own batch is done
+  while (batch->remaining.load() > 0) {
+    if (!tryRun(0)) {
+      std::unique_lock lock(batch->mutex);
+      batch->done.wait_for(lock, std::chrono::microseconds(100),
+                           [&] { return batch->remaining.load() == 0; });
+    }
+  }
+  tasks.clear();
+
+  if (batch->error) {
+    std::rethrow_exception(batch->error);
+  }
+}
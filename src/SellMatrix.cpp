@@ -0,0 +1,172 @@
+#include "../include/SellMatrix.h"
+#include "../include/MatrixChecks.h"
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+
+// SIMD kernels are compiled for their ISA regardless of the build's -m
+// flags and picked at runtime from what the CPU supports
+#if (defined(__x86_64__) || defined(__i386__)) &&                             \
+    (defined(__GNUC__) || defined(__clang__))
+#define SELL_X86_DISPATCH
+#include <immintrin.h>
+#endif
+
+// Sums x over the rows of one chunk's leading SIMD lanes into sums, and
+// returns the first lane it did not handle.
+using ChunkLanesFn = int (*)(const int *slots, const int *lens, int C,
+                             int width, const double *x, double *sums);
+
+#ifdef SELL_X86_DISPATCH
+__attribute__((target("avx512f,avx512vl"))) static int
+chunkLanesAvx512(const int *slots, const int *lens, int C, int width,
+                 const double *x, double *sums) {
+  int lane = 0;
+  // Eight rows per step: lanes past their row's length are masked off
+  for (; lane + 8 <= C; lane += 8) {
+    const __m256i len =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(lens + lane));
+    __m512d acc = _mm512_setzero_pd();
+    for (int j = 0; j < width; ++j) {
+      const __mmask8 live = _mm256_cmpgt_epi32_mask(len, _mm256_set1_epi32(j));
+      const __m256i idx = _mm256_loadu_si256(
+          reinterpret_cast<const __m256i *>(slots + j * C + lane));
+      acc = _mm512_add_pd(
+          acc, _mm512_mask_i32gather_pd(_mm512_setzero_pd(), live, idx, x, 8));
+    }
+    _mm512_storeu_pd(sums + lane, acc);
+  }
+  return lane;
+}
+
+__attribute__((target("avx2"))) static int
+chunkLanesAvx2(const int *slots, const int *lens, int C, int width,
+               const double *x, double *sums) {
+  int lane = 0;
+  // Four rows per step: lanes past their row's length are masked off
+  for (; lane + 4 <= C; lane += 4) {
+    const __m128i len =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(lens + lane));
+    __m256d acc = _mm256_setzero_pd();
+    for (int j = 0; j < width; ++j) {
+      const __m256d live = _mm256_castsi256_pd(
+          _mm256_cvtepi32_epi64(_mm_cmpgt_epi32(len, _mm_set1_epi32(j))));
+      const __m128i idx = _mm_loadu_si128(
+          reinterpret_cast<const __m128i *>(slots + j * C + lane));
+      acc = _mm256_add_pd(
+          acc, _mm256_mask_i32gather_pd(_mm256_setzero_pd(), x, idx, live, 8));
+    }
+    _mm256_storeu_pd(sums + lane, acc);
+  }
+  return lane;
+}
+#endif
+
+// Widest SIMD kernel the CPU runs, or nullptr for scalar only.
+static ChunkLanesFn selectChunkLanes() {
+#ifdef SELL_X86_DISPATCH
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl")) {
+    return chunkLanesAvx512;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return chunkLanesAvx2;
+  }
+#endif
+  return nullptr;
+}
+
+SellMatrix::SellMatrix(const CSRMatrix &csr, int chunkSize, int sortWindow)
+    : C(chunkSize) {
+  if (chunkSize <= 0 || sortWindow <= 0 || sortWindow % chunkSize != 0) {
+    throw std::invalid_argument(
+        "SellMatrix needs positive C and sigma with sigma a multiple of C, "
+        "got C=" +
+        std::to_string(chunkSize) + " sigma=" + std::to_string(sortWindow));
+  }
+  requirePattern("SellMatrix", csr);
+  std::tie(M, N) = csr.shape();
+  const auto &csrRowPtr = csr.getRowPtr();
+  const auto &csrColIdx = csr.getColIdx();
+
+  const int numChunks = (M + C - 1) / C;
+  rowPerm.assign(static_cast<size_t>(numChunks) * C, -1);
+  rowLen.assign(rowPerm.size(), 0);
+
+  // Sort each σ window by decreasing row length; padding rows stay last
+  std::iota(rowPerm.begin(), rowPerm.begin() + M, 0);
+  auto length = [&](int row) { return csrRowPtr[row + 1] - csrRowPtr[row]; };
+  for (int begin = 0; begin < M; begin += sortWindow) {
+    const int end = std::min(M, begin + sortWindow);
+    std::stable_sort(rowPerm.begin() + begin, rowPerm.begin() + end,
+                     [&](int a, int b) { return length(a) > length(b); });
+  }
+  for (int r = 0; r < M; ++r) {
+    rowLen[r] = length(rowPerm[r]);
+  }
+
+  // Each chunk is as wide as its longest row
+  chunkPtr.assign(numChunks + 1, 0);
+  for (int c = 0; c < numChunks; ++c) {
+    const int width =
+        *std::max_element(rowLen.begin() + c * C, rowLen.begin() + (c + 1) * C);
+    chunkPtr[c + 1] = chunkPtr[c] + width * C;
+  }
+
+  colIdx.assign(chunkPtr.back(), 0);
+  for (int r = 0; r < M; ++r) {
+    const int chunk = r / C;
+    const int lane = r % C;
+    const int *cols = csrColIdx.data() + csrRowPtr[rowPerm[r]];
+    for (int j = 0; j < rowLen[r]; ++j) {
+      colIdx[chunkPtr[chunk] + j * C + lane] = cols[j];
+    }
+  }
+}
+
+std::vector<double>
+SellMatrix::multiplyVector(const std::vector<double> &x) const {
+  if (static_cast<int>(x.size()) != N) {
+    throw std::invalid_argument("SpMV dimension mismatch: Matrix cols (" +
+                                std::to_string(N) + ") != Vector size (" +
+                                std::to_string(x.size()) + ")");
+  }
+
+  static const ChunkLanesFn simdLanes = selectChunkLanes();
+  std::vector<double> y(M, 0.0);
+  std::vector<double> sums(C);
+  const int numChunks = static_cast<int>(chunkPtr.size()) - 1;
+
+  for (int c = 0; c < numChunks; ++c) {
+    const int *slots = colIdx.data() + chunkPtr[c];
+    const int *lens = rowLen.data() + c * C;
+    int lane = 0;
+    if (simdLanes) {
+      lane = simdLanes(slots, lens, C, (chunkPtr[c + 1] - chunkPtr[c]) / C,
+                       x.data(), sums.data());
+    }
+
+    // Scalar lanes, for CPUs without AVX2 or a C that is not a multiple
+    for (; lane < C; ++lane) {
+      double acc = 0.0;
+      for (int j = 0; j < lens[lane]; ++j) {
+        acc += x[slots[j * C + lane]];
+      }
+      sums[lane] = acc;
+    }
+
+    for (int l = 0; l < C; ++l) {
+      const int row = rowPerm[c * C + l];
+      if (row >= 0) {
+        y[row] = sums[l];
+      }
+    }
+  }
+  return y;
+}
+
+size_t SellMatrix::storedSlots() const { return colIdx.size(); }
+
+std::pair<int, int> SellMatrix::shape() const { return {M, N}; }
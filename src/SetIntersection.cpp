@@ -0,0 +1,122 @@
+#include "../include/SetIntersection.h"
+#include <algorithm>
+#include <bit>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Ratio of range lengths above which galloping beats a linear merge.
+static constexpr int kGallopRatio = 32;
+
+static int intersectGalloping(const int *small, int ns, const int *large,
+                              int nl, int *out) {
+  int count = 0;
+  const int *pos = large;
+  const int *end = large + nl;
+  for (int i = 0; i < ns && pos != end; ++i) {
+    // Exponential probe from the last match, then binary search the bracket
+    int step = 1;
+    const int *hi = pos;
+    while (hi != end && *hi < small[i]) {
+      pos = hi;
+      hi = (end - hi > step) ? hi + step : end;
+      step <<= 1;
+    }
+    pos = std::lower_bound(pos, hi, small[i]);
+    if (pos != end && *pos == small[i]) {
+      if (out) {
+        out[count] = small[i];
+      }
+      ++count;
+      ++pos;
+    }
+  }
+  return count;
+}
+
+int intersectSorted(const int *a, int na, const int *b, int nb, int *out) {
+  if (na == 0 || nb == 0) {
+    return 0;
+  }
+  if (na > nb * kGallopRatio) {
+    return intersectGalloping(b, nb, a, na, out);
+  }
+  if (nb > na * kGallopRatio) {
+    return intersectGalloping(a, na, b, nb, out);
+  }
+
+  int count = 0;
+  int i = 0, j = 0;
+
+#if defined(__SSE2__)
+  // Compare a 4-block of a against all rotations of a 4-block of b; the
+  // block with the smaller maximum (or both) then advances.
+  while (i + 4 <= na && j + 4 <= nb) {
+    const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+    const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + j));
+
+    __m128i match = _mm_cmpeq_epi32(va, vb);
+    match = _mm_or_si128(
+        match, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1))));
+    match = _mm_or_si128(
+        match, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))));
+    match = _mm_or_si128(
+        match, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3))));
+
+    unsigned mask =
+        static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(match)));
+    if (out) {
+      while (mask) {
+        out[count++] = a[i + std::countr_zero(mask)];
+        mask &= mask - 1;
+      }
+    } else {
+      count += std::popcount(mask);
+    }
+
+    const int aMax = a[i + 3];
+    const int bMax = b[j + 3];
+    if (aMax <= bMax) {
+      i += 4;
+    }
+    if (bMax <= aMax) {
+      j += 4;
+    }
+  }
+#endif
+
+  // Scalar merge of whatever the block loop left over
+  while (i < na && j < nb) {
+    if (a[i] < b[j]) {
+      ++i;
+    } else if (b[j] < a[i]) {
+      ++j;
+    } else {
+      if (out) {
+        out[count] = a[i];
+      }
+      ++count;
+      ++i;
+      ++j;
+    }
+  }
+  return count;
+}
+
+bool intersectsSorted(const int *a, int na, const int *b, int nb) {
+  if (na == 0 || nb == 0 || a[na - 1] < b[0] || b[nb - 1] < a[0]) {
+    return false;
+  }
+  int i = 0, j = 0;
+  while (i < na && j < nb) {
+    if (a[i] < b[j]) {
+      ++i;
+    } else if (b[j] < a[i]) {
+      ++j;
+    } else {
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,53 @@
+#include "../include/SpGEMMWorkspace.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+void MarkerArray::ensureSize(int numCols) {
+  if (static_cast<int>(stamp.size()) < numCols) {
+    stamp.assign(numCols, 0);
+    current = 0;
+  }
+}
+
+uint32_t MarkerArray::next() {
+  if (++current == 0) {
+    std::fill(stamp.begin(), stamp.end(), 0);
+    current = 1;
+  }
+  return current;
+}
+
+SpGEMMWorkspace::SpGEMMWorkspace(int numThreads) {
+  if (numThreads <= 0) {
+    throw std::invalid_argument("SpGEMMWorkspace needs at least one thread.");
+  }
+  threads.resize(numThreads);
+}
+
+SpGEMMWorkspace::ThreadScratch &SpGEMMWorkspace::scratch(int thread) {
+  if (thread < 0 || thread >= numThreads()) {
+    throw std::out_of_range("Workspace thread " + std::to_string(thread) +
+                            " is out of range.");
+  }
+  return threads[thread];
+}
+
+int SpGEMMWorkspace::numThreads() const {
+  return static_cast<int>(threads.size());
+}
+
+void SpGEMMWorkspace::reserve(int numCols, int numRows, size_t nnz) {
+  for (auto &t : threads) {
+    t.marker.ensureSize(numCols);
+    t.rowPtr.reserve(numRows + 1);
+    t.colIdx.reserve(nnz);
+  }
+}
+
+void SpGEMMWorkspace::release() {
+  const int n = numThreads();
+  threads.clear();
+  threads.shrink_to_fit();
+  threads.resize(n);
+}
@@ -0,0 +1,169 @@
+#include "../include/TriangleCounting.h"
+#include "../include/MatrixChecks.h"
+#include "../include/Scheduler.h"
+#include "../include/SetIntersection.h"
+#include "../include/Tuning.h"
+#include <algorithm>
+#include <atomic>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+TriangleCounts countTriangles(const CSRMatrix &adjacency, int numThreads) {
+  auto [n, cols] = adjacency.shape();
+  if (n != cols) {
+    throw std::invalid_argument("countTriangles: adjacency must be square, got " +
+                                std::to_string(n) + "x" + std::to_string(cols));
+  }
+  requirePattern("countTriangles", adjacency);
+  const auto &rowPtr = adjacency.getRowPtr();
+  const auto &colIdx = adjacency.getColIdx();
+
+  // Undirected degree, counting each stored direction of an edge
+  std::vector<int> degree(n, 0);
+  for (int u = 0; u < n; ++u) {
+    for (int p = rowPtr[u]; p < rowPtr[u + 1]; ++p) {
+      if (colIdx[p] != u) {
+        degree[u]++;
+        degree[colIdx[p]]++;
+      }
+    }
+  }
+  auto ranksBefore = [&](int u, int v) {
+    return degree[u] != degree[v] ? degree[u] < degree[v] : u < v;
+  };
+
+  // Orient every edge towards the higher-ranked endpoint, so hubs keep short
+  // out-lists, and build the oriented graph in CSR form
+  std::vector<int> outPtr(n + 1, 0);
+  for (int u = 0; u < n; ++u) {
+    for (int p = rowPtr[u]; p < rowPtr[u + 1]; ++p) {
+      const int v = colIdx[p];
+      if (v != u) {
+        outPtr[(ranksBefore(u, v) ? u : v) + 1]++;
+      }
+    }
+  }
+  for (int u = 0; u < n; ++u) {
+    outPtr[u + 1] += outPtr[u];
+  }
+  std::vector<int> outIdx(outPtr.back());
+  std::vector<int> outOffset(outPtr.begin(), outPtr.end() - 1);
+  for (int u = 0; u < n; ++u) {
+    for (int p = rowPtr[u]; p < rowPtr[u + 1]; ++p) {
+      const int v = colIdx[p];
+      if (v != u) {
+        if (ranksBefore(u, v)) {
+          outIdx[outOffset[u]++] = v;
+        } else {
+          outIdx[outOffset[v]++] = u;
+        }
+      }
+    }
+  }
+
+  // Sort each out-list and drop edges that were stored in both directions
+  std::vector<int> outLen(n);
+  for (int u = 0; u < n; ++u) {
+    auto begin = outIdx.begin() + outPtr[u];
+    auto end = outIdx.begin() + outPtr[u + 1];
+    std::sort(begin, end);
+    outLen[u] = static_cast<int>(std::unique(begin, end) - begin);
+  }
+
+  // An oriented edge (u, v) costs roughly |out(u)| + |out(v)| to intersect
+  std::vector<int64_t> edgeWork(outIdx.size(), 0);
+  for (int u = 0; u < n; ++u) {
+    for (int p = outPtr[u]; p < outPtr[u] + outLen[u]; ++p) {
+      edgeWork[p] = outLen[u] + outLen[outIdx[p]];
+    }
+  }
+
+  std::optional<WorkStealingPool> ownPool;
+  WorkStealingPool &pool = numThreads > 0 ? ownPool.emplace(numThreads)
+                                          : WorkStealingPool::shared();
+  const std::vector<RowChunk> chunks =
+      partitionRowsByWork(outPtr, edgeWork,
+                          pool.size() * kernelThresholds().chunksPerThread,
+                          false);
+
+  std::atomic<int64_t> total{0};
+  std::vector<std::atomic<int64_t>> perVertex(n);
+  std::vector<std::function<void()>> tasks;
+  for (const RowChunk &chunk : chunks) {
+    tasks.emplace_back([&, chunk] {
+      std::vector<int> common;
+      int64_t chunkTotal = 0;
+      for (int u = chunk.rowBegin; u < chunk.rowEnd; ++u) {
+        const int *outU = outIdx.data() + outPtr[u];
+        for (int p = 0; p < outLen[u]; ++p) {
+          const int v = outU[p];
+          const int *outV = outIdx.data() + outPtr[v];
+          common.resize(std::min(outLen[u], outLen[v]));
+
+          const int found =
+              intersectSorted(outU, outLen[u], outV, outLen[v], common.data());
+          if (found == 0) {
+            continue;
+          }
+          chunkTotal += found;
+          perVertex[u].fetch_add(found, std::memory_order_relaxed);
+          perVertex[v].fetch_add(found, std::memory_order_relaxed);
+          for (int i = 0; i < found; ++i) {
+            perVertex[common[i]].fetch_add(1, std::memory_order_relaxed);
+          }
+        }
+      }
+      total.fetch_add(chunkTotal, std::memory_order_relaxed);
+    });
+  }
+  pool.runAll(tasks);
+
+  TriangleCounts counts;
+  counts.total = total.load();
+  counts.perVertex.resize(n);
+  for (int u = 0; u < n; ++u) {
+    counts.perVertex[u] = perVertex[u].load();
+  }
+  return counts;
+}
+
+std::vector<int> countCommonNeighbors(const CSRMatrix &adjacency,
+                                      const std::vector<Coord> &pairs,
+                                      int numThreads) {
+  const int rows = adjacency.shape().first;
+  for (const auto &[u, v] : pairs) {
+    if (u < 0 || u >= rows || v < 0 || v >= rows) {
+      throw std::out_of_range("Vertex pair is out of matrix bounds.");
+    }
+  }
+  requirePattern("countCommonNeighbors", adjacency);
+  const auto &rowPtr = adjacency.getRowPtr();
+  const auto &colIdx = adjacency.getColIdx();
+
+  std::optional<WorkStealingPool> ownPool;
+  WorkStealingPool &pool = numThreads > 0 ? ownPool.emplace(numThreads)
+                                          : WorkStealingPool::shared();
+
+  std::vector<int> counts(pairs.size(), 0);
+  const size_t numChunks =
+      std::min(pairs.size(), static_cast<size_t>(pool.size()) *
+                                 kernelThresholds().chunksPerThread);
+  std::vector<std::function<void()>> tasks;
+  for (size_t c = 0; c < numChunks; ++c) {
+    const size_t begin = pairs.size() * c / numChunks;
+    const size_t end = pairs.size() * (c + 1) / numChunks;
+    tasks.emplace_back([&, begin, end] {
+      for (size_t i = begin; i < end; ++i) {
+        const auto &[u, v] = pairs[i];
+        counts[i] = intersectSorted(colIdx.data() + rowPtr[u],
+                                    rowPtr[u + 1] - rowPtr[u],
+                                    colIdx.data() + rowPtr[v],
+                                    rowPtr[v + 1] - rowPtr[v]);
+      }
+    });
+  }
+  pool.runAll(tasks);
+
+  return counts;
+}
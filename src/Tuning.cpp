@@ -0,0 +1,126 @@
+#include "../include/Tuning.h"
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+// Throws unless every threshold is usable by the kernels.
+static void validate(const KernelThresholds &t) {
+  if (!(t.bitmapRowDensity > 0 && t.bitmapRowDensity <= 1) ||
+      !(t.denseProductDensity > 0 && t.denseProductDensity <= 1)) {
+    throw std::invalid_argument("kernel thresholds: densities must be in (0, 1]");
+  }
+  if (t.flopsPerThread < 1 || t.chunksPerThread < 1) {
+    throw std::invalid_argument(
+        "kernel thresholds: flopsPerThread and chunksPerThread must be >= 1");
+  }
+  if (!(t.outerProductCompression >= 1)) {
+    throw std::invalid_argument(
+        "kernel thresholds: outerProductCompression must be >= 1");
+  }
+}
+
+// Thresholds of the tuning file at defaultTuningPath(), or the defaults.
+static KernelThresholds loadStartupThresholds() {
+  const std::string path = defaultTuningPath();
+  std::error_code ec;
+  if (!std::filesystem::exists(path, ec)) {
+    return {};
+  }
+  try {
+    return loadKernelThresholds(path);
+  } catch (const std::exception &e) {
+    std::clog << "Ignoring tuning file " << path << ": " << e.what()
+              << std::endl;
+    return {};
+  }
+}
+
+static KernelThresholds &currentThresholds() {
+  static KernelThresholds current = loadStartupThresholds();
+  return current;
+}
+
+const KernelThresholds &kernelThresholds() { return currentThresholds(); }
+
+void setKernelThresholds(const KernelThresholds &thresholds) {
+  validate(thresholds);
+  currentThresholds() = thresholds;
+}
+
+std::string defaultTuningPath() {
+  const char *path = std::getenv("MATMUL_TUNING_FILE");
+  return path && *path ? path : "matmul_tuning.cfg";
+}
+
+// Parses the whole of text as a T, or throws naming the line.
+template <typename T>
+static T parseValue(const std::string &text, const std::string &line) {
+  std::istringstream ss(text);
+  T value;
+  if (!(ss >> value) || !(ss >> std::ws).eof()) {
+    throw std::runtime_error("Couldn't parse a tuning value: " + line);
+  }
+  return value;
+}
+
+KernelThresholds loadKernelThresholds(const std::string &filename) {
+  std::ifstream fin(filename);
+  if (!fin.is_open()) {
+    throw std::runtime_error("Could not open " + filename);
+  }
+
+  KernelThresholds t;
+  std::string line;
+  while (std::getline(fin, line)) {
+    const size_t first = line.find_first_not_of(" \t\r");
+    if (first == std::string::npos || line[first] == '#') {
+      continue;
+    }
+    const size_t eq = line.find('=');
+    if (eq == std::string::npos) {
+      throw std::runtime_error("Couldn't parse a tuning line: " + line);
+    }
+    std::string key = line.substr(first, eq - first);
+    key.erase(key.find_last_not_of(" \t") + 1);
+    const std::string value = line.substr(eq + 1);
+
+    if (key == "bitmapRowDensity") {
+      t.bitmapRowDensity = parseValue<double>(value, line);
+    } else if (key == "denseProductDensity") {
+      t.denseProductDensity = parseValue<double>(value, line);
+    } else if (key == "flopsPerThread") {
+      t.flopsPerThread = parseValue<int64_t>(value, line);
+    } else if (key == "outerProductCompression") {
+      t.outerProductCompression = parseValue<double>(value, line);
+    } else if (key == "chunksPerThread") {
+      t.chunksPerThread = parseValue<int>(value, line);
+    } else {
+      throw std::runtime_error("Unknown tuning key: " + key);
+    }
+  }
+  validate(t);
+  return t;
+}
+
+void saveKernelThresholds(const KernelThresholds &thresholds,
+                          const std::string &filename) {
+  std::ofstream fout(filename);
+  if (!fout.is_open()) {
+    throw std::runtime_error("Could not open " + filename);
+  }
+  fout.precision(std::numeric_limits<double>::max_digits10);
+  fout << "# Kernel thresholds measured by MatmulTune\n"
+       << "bitmapRowDensity = " << thresholds.bitmapRowDensity << "\n"
+       << "denseProductDensity = " << thresholds.denseProductDensity << "\n"
+       << "flopsPerThread = " << thresholds.flopsPerThread << "\n"
+       << "outerProductCompression = " << thresholds.outerProductCompression
+       << "\n"
+       << "chunksPerThread = " << thresholds.chunksPerThread << "\n";
+  if (!fout) {
+    throw std::runtime_error("Could not write " + filename);
+  }
+}
@@ -0,0 +1,204 @@
+#include "../include/CSRMatrix.h"
+#include "../include/MatrixUtils.h"
+#include "../include/ProductPlanner.h"
+#include "../include/Tuning.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <thread>
+#include <vector>
+
+// Minimum wall time spent timing one kernel on one input.
+static constexpr std::chrono::milliseconds kMinTimingBudget{50};
+static constexpr int kMinTimingRuns = 3;
+
+// Best single-run time of fn in seconds. The run count is calibrated to the
+// kernel: fn repeats until the time budget is spent, at least kMinTimingRuns
+// times, so fast kernels are sampled often and slow ones only a few times.
+static double timeKernel(const std::function<void()> &fn) {
+  using Clock = std::chrono::steady_clock;
+  double best = std::numeric_limits<double>::infinity();
+  const auto start = Clock::now();
+  for (int run = 0;
+       run < kMinTimingRuns || Clock::now() - start < kMinTimingBudget;
+       ++run) {
+    const auto t1 = Clock::now();
+    fn();
+    const auto t2 = Clock::now();
+    best = std::min(best, std::chrono::duration<double>(t2 - t1).count());
+  }
+  return best;
+}
+
+static CSRMatrix randomMatrix(double density, int rows, int cols, int seed) {
+  return CSRMatrix(generateSparseMatrix(density, rows, cols, seed), rows,
+                   cols);
+}
+
+// Index of the first point from which candidate beats baseline at every
+// later point of the sweep, or candidate.size() if it never settles.
+static size_t crossover(const std::vector<double> &candidate,
+                        const std::vector<double> &baseline) {
+  size_t first = candidate.size();
+  for (size_t i = candidate.size(); i-- > 0;) {
+    if (candidate[i] >= baseline[i]) {
+      break;
+    }
+    first = i;
+  }
+  return first;
+}
+
+// Product densities at which the bitmap and dense formats overtake CSR, on
+// square products whose operand density sweeps geometrically.
+static void tuneDensities(KernelThresholds &t) {
+  const int n = 1024;
+  std::vector<double> productDensity, csr, bitmap, dense;
+  std::cout << "product density     csr (s)  bitmap (s)   dense (s)\n";
+  for (double d = 0.001; d <= 0.04; d *= 1.5) {
+    CSRMatrix A = randomMatrix(d, n, n, 1);
+    CSRMatrix B = randomMatrix(d, n, n, 2);
+    const auto nnz = A.naiveMatmul(B).getColIdx().size();
+    productDensity.push_back(static_cast<double>(nnz) / n / n);
+    csr.push_back(timeKernel([&] { (void)A.naiveMatmul(B); }));
+    bitmap.push_back(
+        timeKernel([&] { multiplyAs(A, B, ProductFormat::BitmapRows); }));
+    dense.push_back(
+        timeKernel([&] { multiplyAs(A, B, ProductFormat::Dense); }));
+    std::cout << std::setw(15) << productDensity.back() << std::setw(12)
+              << csr.back() << std::setw(12) << bitmap.back() << std::setw(12)
+              << dense.back() << "\n";
+  }
+
+  // Beyond the sweep, the format starts paying off above its densest point
+  auto threshold = [&](size_t i) {
+    return i < productDensity.size()
+               ? productDensity[i]
+               : std::min(1.0, 2 * productDensity.back());
+  };
+  t.bitmapRowDensity = threshold(crossover(bitmap, csr));
+  std::vector<double> sparseBest(csr.size());
+  for (size_t i = 0; i < csr.size(); ++i) {
+    sparseBest[i] = std::min(csr[i], bitmap[i]);
+  }
+  t.denseProductDensity = threshold(crossover(dense, sparseBest));
+}
+
+// Flops from which a product split over every hardware thread beats the
+// sequential kernel. planProduct() goes parallel from 2 threads' worth.
+static void tuneFlopsPerThread(KernelThresholds &t, int threads) {
+  if (threads < 2) {
+    std::cout << "single hardware thread: flopsPerThread left at "
+              << t.flopsPerThread << "\n";
+    return;
+  }
+  const int n = 4096;
+  std::vector<double> flops, sequential, parallel;
+  std::cout << "flops             sequential (s)  parallel (s)\n";
+  for (int64_t target = int64_t{1} << 14; target <= int64_t{1} << 24;
+       target <<= 1) {
+    const double d = std::sqrt(static_cast<double>(target) / n / n / n);
+    CSRMatrix A = randomMatrix(d, n, n, 3);
+    CSRMatrix B = randomMatrix(d, n, n, 4);
+    flops.push_back(static_cast<double>(gatherProductStats(A, B).flops));
+    sequential.push_back(timeKernel([&] { (void)A.naiveMatmul(B); }));
+    parallel.push_back(timeKernel([&] { (void)A.parallelMatmul(B, threads); }));
+    std::cout << std::setw(12) << flops.back() << std::setw(18)
+              << sequential.back() << std::setw(14) << parallel.back()
+              << "\n";
+  }
+  const size_t i = crossover(parallel, sequential);
+  const double crossoverFlops = i < flops.size() ? flops[i] : 2 * flops.back();
+  t.flopsPerThread = std::max<int64_t>(1, std::llround(crossoverFlops / 2));
+}
+
+// Largest compression ratio up to which the outer-product kernel beats the
+// row-wise one. Inner dimension k sweeps the hits per output cell,
+// lambda = k * d^2, at a fixed operand density.
+static void tuneOuterProductCompression(KernelThresholds &t, int threads) {
+  const int n = 1024;
+  const double d = 0.02;
+  std::vector<double> compression, outer, rowWise;
+  std::cout << "compression     outer (s)  row-wise (s)\n";
+  for (double lambda = 0.125; lambda <= 8; lambda *= 2) {
+    const int k = static_cast<int>(lambda / (d * d));
+    CSRMatrix A = randomMatrix(d, n, k, 5);
+    CSRMatrix B = randomMatrix(d, k, n, 6);
+    const auto nnz = A.naiveMatmul(B).getColIdx().size();
+    compression.push_back(
+        static_cast<double>(gatherProductStats(A, B).flops) /
+        static_cast<double>(std::max<size_t>(nnz, 1)));
+    outer.push_back(timeKernel([&] { (void)A.outerProductMatmul(B, threads); }));
+    rowWise.push_back(timeKernel([&] { (void)A.parallelMatmul(B, threads); }));
+    std::cout << std::setw(11) << compression.back() << std::setw(14)
+              << outer.back() << std::setw(14) << rowWise.back() << "\n";
+  }
+
+  // Outer product wins on a prefix of the sweep, if anywhere
+  size_t wins = 0;
+  while (wins < outer.size() && outer[wins] < rowWise[wins]) {
+    ++wins;
+  }
+  t.outerProductCompression = wins ? compression[wins - 1] : 1.0;
+}
+
+// Fastest chunk count per pool thread for parallelMatmul.
+static void tuneChunksPerThread(KernelThresholds &t, int threads) {
+  const int n = 4096;
+  CSRMatrix A = randomMatrix(0.002, n, n, 7);
+  CSRMatrix B = randomMatrix(0.002, n, n, 8);
+  double best = std::numeric_limits<double>::infinity();
+  int bestChunks = t.chunksPerThread;
+  std::cout << "chunks/thread  parallel (s)\n";
+  for (int chunks : {1, 2, 4, 8, 16, 32}) {
+    KernelThresholds trial = kernelThresholds();
+    trial.chunksPerThread = chunks;
+    setKernelThresholds(trial);
+    const double seconds =
+        timeKernel([&] { (void)A.parallelMatmul(B, threads); });
+    std::cout << std::setw(13) << chunks << std::setw(14) << seconds << "\n";
+    if (seconds < best) {
+      best = seconds;
+      bestChunks = chunks;
+    }
+  }
+  t.chunksPerThread = bestChunks;
+}
+
+int main(int argc, char **argv) {
+  if (argc > 2) {
+    std::cerr << "usage: " << argv[0] << " [tuning-file]" << std::endl;
+    return 1;
+  }
+  const std::string path = argc == 2 ? argv[1] : defaultTuningPath();
+  const int threads =
+      static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+  // Measure against the defaults, not a previously saved tuning file
+  KernelThresholds tuned;
+  setKernelThresholds(tuned);
+  std::cout << std::setprecision(4);
+
+  std::cout << "--- PRODUCT FORMAT DENSITIES ---" << std::endl;
+  tuneDensities(tuned);
+  std::cout << "--- FLOPS PER THREAD (" << threads << " threads) ---"
+            << std::endl;
+  tuneFlopsPerThread(tuned, threads);
+  std::cout << "--- OUTER PRODUCT COMPRESSION ---" << std::endl;
+  tuneOuterProductCompression(tuned, threads);
+  std::cout << "--- CHUNKS PER THREAD ---" << std::endl;
+  tuneChunksPerThread(tuned, threads);
+
+  // A sweep that never crosses can leave the dense format below the bitmap
+  tuned.denseProductDensity =
+      std::max(tuned.denseProductDensity, tuned.bitmapRowDensity);
+
+  saveKernelThresholds(tuned, path);
+  std::cout << "Wrote " << path << std::endl;
+  return 0;
+}
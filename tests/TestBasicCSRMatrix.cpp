@@ -0,0 +1,76 @@
+#define CATCH_CONFIG_MAIN
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "../include/BasicCSRMatrix.h"
+#include "../include/CSRMatrix.h"
+#include "../include/MatrixUtils.h"
+
+TEST_CASE("BasicCSRMatrix layouts", "[BasicCSRMatrix]") {
+  int M = 150, K = 120, N = 130;
+  CSRMatrix A(generateSparseMatrix(0.04, M, K, 1), M, K);
+  CSRMatrix B(generateSparseMatrix(0.04, K, N, 2), K, N);
+  auto expected = A.naiveMatmul(B).getCoords();
+
+  SECTION("Every layout round-trips and multiplies like CSRMatrix") {
+    WideCSRMatrix wA(A), wB(B);
+    NarrowCSRMatrix nA(A), nB(B);
+    TileCSRMatrix tA(A), tB(B);
+
+    REQUIRE(wA.toCSR().getCoords() == A.getCoords());
+    REQUIRE(nA.toCSR().getCoords() == A.getCoords());
+    REQUIRE(tA.toCSR().getCoords() == A.getCoords());
+    REQUIRE(static_cast<size_t>(wA.nnz()) == A.getColIdx().size());
+
+    REQUIRE(wA.naiveMatmul(wB).getCoords() == expected);
+    REQUIRE(nA.naiveMatmul(nB).getCoords() == expected);
+    REQUIRE(tA.naiveMatmul(tB).getCoords() == expected);
+    REQUIRE(wA.naiveMatmul(wB).shape() == std::pair<int, int>(M, N));
+  }
+
+  SECTION("Dimension errors thrown") {
+    WideCSRMatrix wA(A);
+    REQUIRE_THROWS_AS(wA.naiveMatmul(wA), std::invalid_argument);
+    REQUIRE_THROWS_AS(WideCSRMatrix({0, 2}, {1}, 1, 4),
+                      std::invalid_argument);
+  }
+
+  SECTION("Valued matrices are rejected") {
+    CSRMatrix valued(A.getRowPtr(), A.getColIdx(),
+                     std::vector<double>(A.getColIdx().size(), 2.0), M, K);
+    REQUIRE_THROWS_AS(WideCSRMatrix(valued), std::invalid_argument);
+  }
+
+  SECTION("Types too narrow for the matrix are rejected") {
+    CSRMatrix wide({{0, 70000}}, 1, 70001);
+    REQUIRE_THROWS_AS(NarrowCSRMatrix(wide), std::overflow_error);
+    REQUIRE_NOTHROW(WideCSRMatrix(wide));
+
+    // A dense 300 x 300 square has 90000 non-zeros, past 16-bit offsets
+    std::vector<Coord> ones;
+    for (int i = 0; i < 300; ++i) {
+      ones.push_back({0, i});
+      if (i > 0) {
+        ones.push_back({i, 0});
+      }
+    }
+    TileCSRMatrix T(CSRMatrix(ones, 300, 300));
+    REQUIRE_THROWS_AS(T.naiveMatmul(T), std::overflow_error);
+    REQUIRE(NarrowCSRMatrix(CSRMatrix(ones, 300, 300))
+                .naiveMatmul(NarrowCSRMatrix(CSRMatrix(ones, 300, 300)))
+                .nnz() == 90000);
+
+    // Converting a CSR with more than 65535 non-zeros to 16-bit offsets
+    std::vector<Coord> full;
+    for (int i = 0; i < 300; ++i) {
+      for (int j = 0; j < 300; ++j) {
+        if (i != j) {
+          full.push_back({i, j});
+        }
+      }
+    }
+    CSRMatrix F(full, 300, 300);
+    REQUIRE_THROWS_AS(TileCSRMatrix(F), std::overflow_error);
+    REQUIRE(NarrowCSRMatrix(F).nnz() == 89700);
+  }
+}
@@ -0,0 +1,98 @@
+#define CATCH_CONFIG_MAIN
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "../include/BlockCSRMatrix.h"
+#include "../include/CSRMatrix.h"
+#include "../include/MatrixUtils.h"
+#include <algorithm>
+
+// Dense diagonal blocks of the given width over a sparse background
+static std::vector<Coord> blockDiagonalCoords(int n, int width, int seed) {
+  auto coords = generateSparseMatrix(0.002, n, n, seed);
+  for (int start = 0; start < n; start += width) {
+    for (int r = start; r < std::min(n, start + width); ++r) {
+      for (int c = start; c < std::min(n, start + width); ++c) {
+        if ((r * 7 + c * 3 + seed) % 4 != 0) {
+          coords.push_back({r, c});
+        }
+      }
+    }
+  }
+  std::sort(coords.begin(), coords.end(), [](const Coord &a, const Coord &b) {
+    return a.row != b.row ? a.row < b.row : a.col < b.col;
+  });
+  coords.erase(std::unique(coords.begin(), coords.end()), coords.end());
+  return coords;
+}
+
+TEST_CASE("BlockCSRMatrix conversions", "[BlockCSRMatrix]") {
+  int M = 203, N = 150;
+  CSRMatrix A(generateSparseMatrix(0.03, M, N, 1), M, N);
+
+  REQUIRE_THROWS_AS(BlockCSRMatrix(A, 16), std::invalid_argument);
+  CSRMatrix valued(A.getRowPtr(), A.getColIdx(),
+                   std::vector<double>(A.getColIdx().size(), 2.0), M, N);
+  REQUIRE_THROWS_AS(BlockCSRMatrix(valued), std::invalid_argument);
+
+  SECTION("Round trip for both tile sizes") {
+    for (int tile : {8, 64}) {
+      BlockCSRMatrix B(A, tile);
+      REQUIRE(B.tileSize() == tile);
+      REQUIRE(B.shape() == std::pair<int, int>(M, N));
+      REQUIRE(B.nnz() == A.getColIdx().size());
+      REQUIRE(B.toCSR().getCoords() == A.getCoords());
+    }
+  }
+
+  SECTION("Automatic tile size follows block density") {
+    REQUIRE(BlockCSRMatrix(A).tileSize() == 8);
+    int n = 256;
+    CSRMatrix D(blockDiagonalCoords(n, 64, 2), n, n);
+    BlockCSRMatrix B(D);
+    REQUIRE(B.tileSize() == 64);
+    REQUIRE(B.toCSR().getCoords() == D.getCoords());
+  }
+}
+
+TEST_CASE("BlockCSRMatrix naiveMatmul", "[BlockCSRMatrix]") {
+  SECTION("Errors thrown") {
+    CSRMatrix A(generateSparseMatrix(0.05, 40, 30, 1), 40, 30);
+    CSRMatrix B(generateSparseMatrix(0.05, 30, 20, 2), 30, 20);
+    REQUIRE_THROWS_AS(BlockCSRMatrix(A, 8).naiveMatmul(BlockCSRMatrix(A, 8)),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(BlockCSRMatrix(A, 8).naiveMatmul(BlockCSRMatrix(B, 64)),
+                      std::invalid_argument);
+  }
+
+  SECTION("Matches CSR on random and block-diagonal matrices") {
+    int M = 190, K = 170, N = 210;
+    CSRMatrix A(generateSparseMatrix(0.02, M, K, 3), M, K);
+    CSRMatrix B(generateSparseMatrix(0.02, K, N, 4), K, N);
+    int n = 300;
+    CSRMatrix D(blockDiagonalCoords(n, 20, 5), n, n);
+    CSRMatrix E(blockDiagonalCoords(n, 50, 6), n, n);
+
+    for (int tile : {8, 64}) {
+      REQUIRE(BlockCSRMatrix(A, tile)
+                  .naiveMatmul(BlockCSRMatrix(B, tile))
+                  .toCSR()
+                  .getCoords() == A.naiveMatmul(B).getCoords());
+      BlockCSRMatrix C =
+          BlockCSRMatrix(D, tile).naiveMatmul(BlockCSRMatrix(E, tile));
+      REQUIRE(C.shape() == std::pair<int, int>(n, n));
+      REQUIRE(C.toCSR().getCoords() == D.naiveMatmul(E).getCoords());
+    }
+  }
+
+  SECTION("Matches CSR on the banded data matrices") {
+    CSRMatrix A("bwm200.mtx");
+    CSRMatrix B("rdb200.mtx");
+    for (int tile : {0, 8, 64}) {
+      BlockCSRMatrix bA(A, tile);
+      BlockCSRMatrix bB(B, bA.tileSize());
+      REQUIRE(bA.naiveMatmul(bB).toCSR().getCoords() ==
+              A.naiveMatmul(B).getCoords());
+    }
+  }
+}
@@ -6,6 +6,7 @@
 
 #include "../include/CSRMatrix.h"
 #include "../include/MatrixUtils.h"
+#include "../include/Semiring.h"
 #include "../include/Types.h"
 #include <fstream>
 
@@ -323,4 +324,570 @@ TEST_CASE("CSRMatrix batched optimized matmul", "[CSRMatrix]") {
       }
     }
   }
-}
\ No newline at end of file
+}
+
+TEST_CASE("CSRMatrix outerProductMatmul", "[CSRMatrix]") {
+  SECTION("Check mismatch error thrown") {
+    CSRMatrix A(generateSparseMatrix(0.05, 100, 5, 42), 100, 5);
+    CSRMatrix B(generateSparseMatrix(0.05, 10, 100, 43), 10, 100);
+
+    REQUIRE_THROWS_AS(A.outerProductMatmul(B), std::invalid_argument);
+  }
+
+  SECTION("Trec4 x Trec5") {
+    CSRMatrix A("Trec4.mtx");
+    CSRMatrix B("Trec5.mtx");
+
+    auto expectedCoords = A.naiveMatmul(B).getCoords();
+    CSRMatrix C = A.outerProductMatmul(B);
+
+    REQUIRE(C.shape() == std::pair<int, int>(2, 7));
+    REQUIRE(C.getCoords() == expectedCoords);
+  }
+
+  SECTION("Matches naive matmul for any thread count") {
+    int M = 300, K = 200, N = 250;
+    CSRMatrix A(generateSparseMatrix(0.02, M, K, 1), M, K);
+    CSRMatrix B(generateSparseMatrix(0.02, K, N, 2), K, N);
+
+    auto expectedCoords = A.naiveMatmul(B).getCoords();
+    for (int threads : {1, 2, 3, 8}) {
+      CSRMatrix C = A.outerProductMatmul(B, threads);
+      REQUIRE(C.shape() == std::pair<int, int>(M, N));
+      REQUIRE(C.getCoords() == expectedCoords);
+    }
+  }
+}
+
+TEST_CASE("CSRMatrix parallelMatmul", "[CSRMatrix]") {
+  SECTION("Check mismatch error thrown") {
+    CSRMatrix A(generateSparseMatrix(0.05, 100, 5, 42), 100, 5);
+    CSRMatrix B(generateSparseMatrix(0.05, 10, 100, 43), 10, 100);
+
+    REQUIRE_THROWS_AS(A.parallelMatmul(B), std::invalid_argument);
+  }
+
+  SECTION("Matches naive matmul for any thread count") {
+    int M = 300, K = 200, N = 250;
+    CSRMatrix A(generateSparseMatrix(0.02, M, K, 1), M, K);
+    CSRMatrix B(generateSparseMatrix(0.02, K, N, 2), K, N);
+
+    auto expectedCoords = A.naiveMatmul(B).getCoords();
+    for (int threads : {0, 1, 2, 5}) {
+      CSRMatrix C = A.parallelMatmul(B, threads);
+      REQUIRE(C.shape() == std::pair<int, int>(M, N));
+      REQUIRE(C.getCoords() == expectedCoords);
+    }
+  }
+
+  SECTION("Hub row is split across chunks") {
+    int M = 200, K = 200, N = 200;
+    auto coordsA = generateSparseMatrix(0.01, M, K, 3);
+    for (int col = 0; col < K; ++col) {
+      coordsA.push_back({7, col}); // row 7 touches every row of B
+    }
+    std::sort(coordsA.begin(), coordsA.end(),
+              [](const Coord &a, const Coord &b) {
+                return a.row != b.row ? a.row < b.row : a.col < b.col;
+              });
+    coordsA.erase(std::unique(coordsA.begin(), coordsA.end()), coordsA.end());
+
+    CSRMatrix A(coordsA, M, K);
+    CSRMatrix B(generateSparseMatrix(0.05, K, N, 4), K, N);
+
+    REQUIRE(A.parallelMatmul(B, 4).getCoords() ==
+            A.naiveMatmul(B).getCoords());
+  }
+}
+
+TEST_CASE("CSRMatrix batched parallel matmul", "[CSRMatrix]") {
+  double sparsity = 0.01;
+  int N = 100;
+
+  SECTION("Dimension error thrown") {
+    CSRMatrix A(generateSparseMatrix(sparsity, N, N, 1), N, N);
+
+    // First right matrix is valid, second has mismatched dimensions
+    std::vector<CSRMatrix> rights;
+    rights.emplace_back(generateSparseMatrix(sparsity, N, N, 2), N, N);
+    rights.emplace_back(generateSparseMatrix(sparsity, N + 1, N, 3), N + 1,
+                        N); // Invalid
+
+    REQUIRE_THROWS_AS(A.batchParallelMatmul(rights), std::invalid_argument);
+  }
+
+  SECTION("Correctness check, uneven batch") {
+    CSRMatrix A(generateSparseMatrix(sparsity, N, N, 1), N, N);
+
+    // Right-hand matrices of very different density and width
+    std::vector<CSRMatrix> rights;
+    rights.emplace_back(generateSparseMatrix(0.2, N, 3 * N, 100), N, 3 * N);
+    rights.emplace_back(generateSparseMatrix(0.01, N, 7, 101), N, 7);
+    rights.emplace_back(generateSparseMatrix(0.05, N, N, 102), N, N);
+
+    auto results = A.batchParallelMatmul(rights, 3);
+
+    REQUIRE(results.size() == rights.size());
+    for (size_t i = 0; i < rights.size(); ++i) {
+      CSRMatrix expected = A.naiveMatmul(rights[i]);
+      REQUIRE(results[i].shape() == expected.shape());
+      REQUIRE(results[i].getCoords() == expected.getCoords());
+    }
+  }
+}
+
+TEST_CASE("CSRMatrix fused batched matmul", "[CSRMatrix]") {
+  int N = 100;
+
+  CSRMatrix A(generateSparseMatrix(0.02, N, N, 1), N, N);
+
+  // Right-hand matrices of different widths share A as the left operand
+  std::vector<CSRMatrix> rights;
+  rights.emplace_back(generateSparseMatrix(0.05, N, N, 100), N, N);
+  rights.emplace_back(generateSparseMatrix(0.1, N, 13, 101), N, 13);
+  rights.emplace_back(generateSparseMatrix(0.01, N, 2 * N, 102), N, 2 * N);
+
+  SECTION("Dimension error thrown") {
+    std::vector<CSRMatrix> bad = rights;
+    bad.emplace_back(generateSparseMatrix(0.01, N + 1, N, 3), N + 1, N);
+
+    REQUIRE_THROWS_AS(A.batchNaiveMatmul(bad, true), std::invalid_argument);
+    REQUIRE_THROWS_AS(A.batchOptimizedMatmul(bad, 0.1, true),
+                      std::invalid_argument);
+  }
+
+  SECTION("Fused naive and optimized match per-item naive matmul") {
+    auto naiveResults = A.batchNaiveMatmul(rights, true);
+    auto optimizedResults = A.batchOptimizedMatmul(rights, 0.1, true);
+
+    REQUIRE(naiveResults.size() == rights.size());
+    REQUIRE(optimizedResults.size() == rights.size());
+    for (size_t i = 0; i < rights.size(); ++i) {
+      CSRMatrix expected = A.naiveMatmul(rights[i]);
+      REQUIRE(naiveResults[i].shape() == expected.shape());
+      REQUIRE(naiveResults[i].getCoords() == expected.getCoords());
+      REQUIRE(optimizedResults[i].shape() == expected.shape());
+      REQUIRE(optimizedResults[i].getCoords() == expected.getCoords());
+    }
+  }
+}
+
+TEST_CASE("CSRMatrix multiplyInto", "[CSRMatrix]") {
+  int M = 200, K = 150, N = 180;
+  CSRMatrix A(generateSparseMatrix(0.03, M, K, 1), M, K);
+  CSRMatrix B(generateSparseMatrix(0.03, K, N, 2), K, N);
+
+  SECTION("Check mismatch error thrown") {
+    CSRMatrix out;
+    REQUIRE_THROWS_AS(B.multiplyInto(B, out), std::invalid_argument);
+  }
+
+  SECTION("Matches naive matmul when overwriting an existing matrix") {
+    auto expectedCoords = A.naiveMatmul(B).getCoords();
+
+    CSRMatrix out;
+    A.multiplyInto(B, out);
+    REQUIRE(out.shape() == std::pair<int, int>(M, N));
+    REQUIRE(out.getCoords() == expectedCoords);
+
+    // Overwrite a previous, differently shaped product
+    CSRMatrix stale = A;
+    SpGEMMWorkspace ws;
+    A.multiplyInto(B, stale, ws);
+    REQUIRE(stale.shape() == std::pair<int, int>(M, N));
+    REQUIRE(stale.getCoords() == expectedCoords);
+  }
+
+  SECTION("Output may alias an operand") {
+    CSRMatrix S(generateSparseMatrix(0.05, 100, 100, 3), 100, 100);
+    auto expectedCoords = S.naiveMatmul(S).getCoords();
+
+    S.multiplyInto(S, S);
+    REQUIRE(S.getCoords() == expectedCoords);
+  }
+}
+
+TEST_CASE("CSRMatrix maskedMatmul", "[CSRMatrix]") {
+  int M = 150, K = 120, N = 140;
+  CSRMatrix A(generateSparseMatrix(0.04, M, K, 1), M, K);
+  CSRMatrix B(generateSparseMatrix(0.04, K, N, 2), K, N);
+  CSRMatrix mask(generateSparseMatrix(0.1, M, N, 3), M, N);
+
+  auto product = A.naiveMatmul(B).getCoords();
+  auto maskCoords = mask.getCoords();
+  auto coordSorter = [](const Coord &a, const Coord &b) {
+    return (a.row != b.row) ? (a.row < b.row) : (a.col < b.col);
+  };
+
+  SECTION("Dimension errors thrown") {
+    CSRMatrix badMask(generateSparseMatrix(0.1, M, N + 1, 4), M, N + 1);
+    REQUIRE_THROWS_AS(A.maskedMatmul(B, badMask), std::invalid_argument);
+    REQUIRE_THROWS_AS(B.maskedMatmul(B, mask), std::invalid_argument);
+  }
+
+  SECTION("Masked product is the intersection with the mask") {
+    std::vector<Coord> expected;
+    std::set_intersection(product.begin(), product.end(), maskCoords.begin(),
+                          maskCoords.end(), std::back_inserter(expected),
+                          coordSorter);
+
+    CSRMatrix C = A.maskedMatmul(B, mask);
+    REQUIRE(C.shape() == std::pair<int, int>(M, N));
+    REQUIRE(C.getCoords() == expected);
+  }
+
+  SECTION("Complemented mask keeps the entries outside the mask") {
+    std::vector<Coord> expected;
+    std::set_difference(product.begin(), product.end(), maskCoords.begin(),
+                        maskCoords.end(), std::back_inserter(expected),
+                        coordSorter);
+
+    CSRMatrix C = A.maskedMatmul(B, mask, true);
+    REQUIRE(C.shape() == std::pair<int, int>(M, N));
+    REQUIRE(C.getCoords() == expected);
+  }
+}
+
+TEST_CASE("CSRMatrix transpose kernels", "[CSRMatrix]") {
+  auto transposeOf = [](const CSRMatrix &mat) {
+    auto [rows, cols] = mat.shape();
+    std::vector<Coord> coords;
+    for (const Coord &c : mat.getCoords()) {
+      coords.push_back({c.col, c.row});
+    }
+    return CSRMatrix(coords, cols, rows);
+  };
+
+  int M = 130, K = 110, N = 120;
+  CSRMatrix A(generateSparseMatrix(0.05, K, M, 1), K, M);
+  CSRMatrix B(generateSparseMatrix(0.05, K, N, 2), K, N);
+
+  SECTION("transpose matches an explicit rebuild") {
+    CSRMatrix expected = transposeOf(A);
+    for (int threads : {1, 3}) {
+      CSRMatrix T = A.transpose(threads);
+      REQUIRE(T.shape() == std::pair<int, int>(M, K));
+      REQUIRE(T.getRowPtr() == expected.getRowPtr());
+      REQUIRE(T.getColIdx() == expected.getColIdx());
+    }
+  }
+
+  SECTION("transposeMatmul computes A^T x B") {
+    auto expected = transposeOf(A).naiveMatmul(B).getCoords();
+    CSRMatrix C = A.transposeMatmul(B, 2);
+    REQUIRE(C.shape() == std::pair<int, int>(M, N));
+    REQUIRE(C.getCoords() == expected);
+    REQUIRE_THROWS_AS(A.transposeMatmul(transposeOf(B)),
+                      std::invalid_argument);
+  }
+
+  SECTION("matmulTranspose computes X x Y^T") {
+    CSRMatrix X = transposeOf(A);
+    CSRMatrix Y = transposeOf(B);
+    auto expected = X.naiveMatmul(B).getCoords();
+    CSRMatrix C = X.matmulTranspose(Y, 2);
+    REQUIRE(C.shape() == std::pair<int, int>(M, N));
+    REQUIRE(C.getCoords() == expected);
+    REQUIRE_THROWS_AS(X.matmulTranspose(B), std::invalid_argument);
+  }
+
+  SECTION("matmulTranspose on a small output intersects rows directly") {
+    CSRMatrix X(generateSparseMatrix(0.3, 4, 200, 3), 4, 200);
+    CSRMatrix Y(generateSparseMatrix(0.3, 5, 200, 4), 5, 200);
+    auto expected = X.naiveMatmul(transposeOf(Y)).getCoords();
+    CSRMatrix C = X.matmulTranspose(Y);
+    REQUIRE(C.shape() == std::pair<int, int>(4, 5));
+    REQUIRE(C.getCoords() == expected);
+  }
+}
+
+TEST_CASE("CSRMatrix symmetricMatmul", "[CSRMatrix]") {
+  int M = 140, K = 90;
+  CSRMatrix A(generateSparseMatrix(0.04, M, K, 5), M, K);
+  std::vector<Coord> transposed;
+  for (const Coord &c : A.getCoords()) {
+    transposed.push_back({c.col, c.row});
+  }
+  CSRMatrix AT(transposed, K, M);
+  auto full = A.naiveMatmul(AT).getCoords();
+
+  SECTION("Upper triangle matches the full product") {
+    std::vector<Coord> expected;
+    std::copy_if(full.begin(), full.end(), std::back_inserter(expected),
+                 [](const Coord &c) { return c.col >= c.row; });
+    for (int threads : {1, 3}) {
+      CSRMatrix U = A.symmetricMatmul(false, threads);
+      REQUIRE(U.shape() == std::pair<int, int>(M, M));
+      REQUIRE(U.getCoords() == expected);
+    }
+  }
+
+  SECTION("Mirrored output matches the full product") {
+    CSRMatrix C = A.symmetricMatmul(true, 2);
+    REQUIRE(C.shape() == std::pair<int, int>(M, M));
+    REQUIRE(C.getCoords() == full);
+    REQUIRE(A.symmetricMatmul().mirrorUpperTriangle().getCoords() == full);
+    REQUIRE_THROWS_AS(A.mirrorUpperTriangle(), std::invalid_argument);
+  }
+}
+
+TEST_CASE("CSRMatrix multiplyAccumulate", "[CSRMatrix]") {
+  int M = 120, K = 100, N = 110;
+  CSRMatrix A(generateSparseMatrix(0.03, M, K, 1), M, K);
+  CSRMatrix B(generateSparseMatrix(0.03, K, N, 2), K, N);
+  CSRMatrix C(generateSparseMatrix(0.05, M, N, 3), M, N);
+
+  auto product = A.naiveMatmul(B).getCoords();
+  auto initial = C.getCoords();
+  auto coordSorter = [](const Coord &a, const Coord &b) {
+    return (a.row != b.row) ? (a.row < b.row) : (a.col < b.col);
+  };
+  std::vector<Coord> expected;
+  std::set_union(product.begin(), product.end(), initial.begin(),
+                 initial.end(), std::back_inserter(expected), coordSorter);
+
+  SECTION("Dimension errors thrown") {
+    CSRMatrix bad(generateSparseMatrix(0.05, M, N + 1, 4), M, N + 1);
+    REQUIRE_THROWS_AS(A.multiplyAccumulate(B, bad), std::invalid_argument);
+    REQUIRE_THROWS_AS(B.multiplyAccumulate(B, C), std::invalid_argument);
+  }
+
+  SECTION("Accumulates the union of C and A x B") {
+    A.multiplyAccumulate(B, C);
+    REQUIRE(C.shape() == std::pair<int, int>(M, N));
+    REQUIRE(C.getCoords() == expected);
+
+    // Accumulating the same product again changes nothing
+    A.multiplyAccumulate(B, C);
+    REQUIRE(C.getCoords() == expected);
+  }
+
+  SECTION("Workspace overload gives the same result") {
+    SpGEMMWorkspace workspace;
+    A.multiplyAccumulate(B, C, workspace);
+    REQUIRE(C.getCoords() == expected);
+  }
+
+  SECTION("Accumulator may alias the left operand") {
+    CSRMatrix S(generateSparseMatrix(0.02, M, M, 5), M, M);
+    auto closure = S.getCoords();
+    auto square = S.naiveMatmul(S).getCoords();
+    std::vector<Coord> reach;
+    std::set_union(closure.begin(), closure.end(), square.begin(),
+                   square.end(), std::back_inserter(reach), coordSorter);
+
+    S.multiplyAccumulate(S, S);
+    REQUIRE(S.getCoords() == reach);
+  }
+}
+
+TEST_CASE("CSRMatrix power and transitiveClosure", "[CSRMatrix]") {
+  int n = 150;
+  CSRMatrix A(generateSparseMatrix(0.01, n, n, 6), n, n);
+
+  SECTION("Errors thrown") {
+    CSRMatrix rect(generateSparseMatrix(0.01, n, n + 1, 7), n, n + 1);
+    REQUIRE_THROWS_AS(rect.power(2), std::invalid_argument);
+    REQUIRE_THROWS_AS(A.power(-1), std::invalid_argument);
+    REQUIRE_THROWS_AS(rect.transitiveClosure(), std::invalid_argument);
+  }
+
+  SECTION("power matches repeated multiplication") {
+    auto identity = A.power(0).getCoords();
+    REQUIRE(identity.size() == static_cast<size_t>(n));
+    REQUIRE(A.power(1).getCoords() == A.getCoords());
+
+    CSRMatrix expected = A;
+    for (int k = 2; k <= 7; ++k) {
+      expected = expected.naiveMatmul(A);
+      REQUIRE(A.power(k, 1).getCoords() == expected.getCoords());
+      REQUIRE(A.power(k, 2).getCoords() == expected.getCoords());
+    }
+  }
+
+  SECTION("power of an idempotent matrix stops early and stays correct") {
+    // A complete block is its own square
+    std::vector<Coord> block;
+    for (int i = 0; i < 5; ++i) {
+      for (int j = 0; j < 5; ++j) {
+        block.push_back({i, j});
+      }
+    }
+    CSRMatrix J(block, 8, 8);
+    REQUIRE(J.power(1000).getCoords() == block);
+  }
+
+  SECTION("transitiveClosure matches the union of all powers") {
+    auto coordSorter = [](const Coord &a, const Coord &b) {
+      return (a.row != b.row) ? (a.row < b.row) : (a.col < b.col);
+    };
+    std::vector<Coord> expected = A.getCoords();
+    CSRMatrix walk = A;
+    for (int k = 2; k <= n; ++k) {
+      walk = walk.naiveMatmul(A);
+      auto step = walk.getCoords();
+      std::vector<Coord> merged;
+      std::set_union(expected.begin(), expected.end(), step.begin(),
+                     step.end(), std::back_inserter(merged), coordSorter);
+      if (merged.size() == expected.size() && step.empty()) {
+        break;
+      }
+      expected.swap(merged);
+    }
+
+    REQUIRE(A.transitiveClosure(1).getCoords() == expected);
+    REQUIRE(A.transitiveClosure(2).getCoords() == expected);
+  }
+}
+
+TEST_CASE("CSRMatrix semiringMatmul", "[CSRMatrix]") {
+  // 0 -> 1 (2.0), 0 -> 2 (5.0), 1 -> 3 (1.0), 2 -> 3 (0.5), 3 -> 0 (4.0)
+  CSRMatrix G({0, 2, 3, 4, 5}, {1, 2, 3, 3, 0}, {2.0, 5.0, 1.0, 0.5, 4.0}, 4,
+              4);
+  REQUIRE(G.getValues().size() == 5);
+  REQUIRE_THROWS_AS(CSRMatrix({0, 1}, {0}, {1.0, 2.0}, 1, 1),
+                    std::invalid_argument);
+
+  SECTION("Boolean semiring is the pattern product") {
+    int M = 80, K = 70, N = 90;
+    CSRMatrix A(generateSparseMatrix(0.05, M, K, 1), M, K);
+    CSRMatrix B(generateSparseMatrix(0.05, K, N, 2), K, N);
+    CSRMatrix C = A.semiringMatmul<BooleanSemiring>(B);
+    REQUIRE(C.getCoords() == A.naiveMatmul(B).getCoords());
+    REQUIRE(C.getValues().empty());
+    REQUIRE_THROWS_AS(A.semiringMatmul<PlusTimesSemiring>(A),
+                      std::invalid_argument);
+  }
+
+  SECTION("Plus-times counts paths on a pattern-only matrix") {
+    CSRMatrix pattern(G.getCoords(), 4, 4);
+    CSRMatrix paths = pattern.semiringMatmul<PlusTimesSemiring>(pattern);
+    // Two-step paths: 0 -> 3 twice, 1 -> 0, 2 -> 0, 3 -> 1, 3 -> 2
+    REQUIRE(paths.getCoords() ==
+            std::vector<Coord>{{0, 3}, {1, 0}, {2, 0}, {3, 1}, {3, 2}});
+    REQUIRE(paths.getValues() == std::vector<double>{2, 1, 1, 1, 1});
+  }
+
+  SECTION("Min-plus gives two-step shortest paths") {
+    CSRMatrix dist = G.semiringMatmul<MinPlusSemiring>(G);
+    REQUIRE(dist.getCoords() ==
+            std::vector<Coord>{{0, 3}, {1, 0}, {2, 0}, {3, 1}, {3, 2}});
+    REQUIRE(dist.getValues() == std::vector<double>{3.0, 5.0, 4.5, 6.0, 9.0});
+  }
+
+  SECTION("Max-times keeps the best product") {
+    CSRMatrix best = G.semiringMatmul<MaxTimesSemiring>(G);
+    REQUIRE(best.getValues() == std::vector<double>{2.5, 4.0, 2.0, 8.0, 20.0});
+  }
+
+  SECTION("Parallel products match the sequential kernel") {
+    // Small integer values keep plus-times sums exact in any order
+    int M = 120, K = 100, N = 110;
+    CSRMatrix A(generateSparseMatrix(0.08, M, K, 3), M, K);
+    CSRMatrix B(generateSparseMatrix(0.08, K, N, 4), K, N);
+    std::vector<double> aValues(A.getColIdx().size());
+    for (size_t p = 0; p < aValues.size(); ++p) {
+      aValues[p] = static_cast<double>(p % 5 + 1);
+    }
+    CSRMatrix valued(A.getRowPtr(), A.getColIdx(), aValues, M, K);
+
+    for (int threads : {2, 4, 0}) {
+      CSRMatrix sum = valued.semiringMatmul<PlusTimesSemiring>(B);
+      CSRMatrix parallelSum =
+          valued.semiringMatmul<PlusTimesSemiring>(B, threads);
+      REQUIRE(parallelSum.getCoords() == sum.getCoords());
+      REQUIRE(parallelSum.getValues() == sum.getValues());
+
+      CSRMatrix dist = valued.semiringMatmul<MinPlusSemiring>(B);
+      REQUIRE(valued.semiringMatmul<MinPlusSemiring>(B, threads).getValues() ==
+              dist.getValues());
+      REQUIRE(A.semiringMatmul<BooleanSemiring>(B, threads).getCoords() ==
+              A.naiveMatmul(B).getCoords());
+    }
+  }
+
+  SECTION("Boolean kernels reject valued operands") {
+    CSRMatrix out;
+    REQUIRE_THROWS_AS(G.naiveMatmul(G), std::invalid_argument);
+    REQUIRE_THROWS_AS(G.parallelMatmul(G, 2), std::invalid_argument);
+    REQUIRE_THROWS_AS(G.multiplyInto(G, out), std::invalid_argument);
+    REQUIRE_THROWS_AS(G.power(1), std::invalid_argument);
+    CSRMatrix pattern(G.getCoords(), 4, 4);
+    REQUIRE(G.semiringMatmul<BooleanSemiring>(G).getCoords() ==
+            pattern.naiveMatmul(pattern).getCoords());
+  }
+
+  SECTION("multiplyVector weights entries by their values") {
+    CSRMatrix pattern(G.getCoords(), 4, 4);
+    std::vector<double> x = {1, 2, 3, 4};
+    REQUIRE(G.multiplyVector(x) == std::vector<double>{19, 4, 2, 4});
+    REQUIRE(pattern.multiplyVector(x) == std::vector<double>{5, 4, 4, 1});
+  }
+
+  SECTION("Transpose carries values") {
+    CSRMatrix Gt = G.transpose(2);
+    REQUIRE(Gt.getCoords() ==
+            std::vector<Coord>{{0, 3}, {1, 0}, {2, 0}, {3, 1}, {3, 2}});
+    REQUIRE(Gt.getValues() == std::vector<double>{4.0, 2.0, 5.0, 1.0, 0.5});
+    REQUIRE(Gt.transpose().getValues() == G.getValues());
+  }
+
+  SECTION("Boolean kernels drop stale values from reused outputs") {
+    CSRMatrix pattern(G.getCoords(), 4, 4);
+    CSRMatrix out = G;
+    pattern.multiplyInto(pattern, out);
+    REQUIRE(out.getValues().empty());
+  }
+}
+
+TEST_CASE("CSRMatrix dedupRowsMatmul", "[CSRMatrix]") {
+  // Category-style operand: 300 rows drawn from 12 distinct patterns, plus
+  // a few empty rows
+  int K = 80, N = 90, patterns = 12;
+  CSRMatrix P(generateSparseMatrix(0.08, patterns, K, 3), patterns, K);
+  std::vector<Coord> coords;
+  int M = 0;
+  for (int i = 0; i < 300; ++i, ++M) {
+    const int pattern = (i * 7) % (patterns + 1);
+    for (const auto &[r, c] : P.getCoords()) {
+      if (r == pattern) {
+        coords.push_back({M, c});
+      }
+    }
+  }
+  CSRMatrix A(coords, M, K);
+  CSRMatrix B(generateSparseMatrix(0.05, K, N, 4), K, N);
+  auto expected = A.naiveMatmul(B).getCoords();
+
+  SECTION("Identical rows share a representative") {
+    auto rep = A.duplicateRowRepresentatives();
+    const auto &rowPtr = A.getRowPtr();
+    const auto &colIdx = A.getColIdx();
+    for (int i = 0; i < M; ++i) {
+      REQUIRE(rep[i] <= i);
+      REQUIRE(rep[rep[i]] == rep[i]);
+      REQUIRE(std::equal(colIdx.begin() + rowPtr[i],
+                         colIdx.begin() + rowPtr[i + 1],
+                         colIdx.begin() + rowPtr[rep[i]],
+                         colIdx.begin() + rowPtr[rep[i] + 1]));
+    }
+    int distinct = 0;
+    for (int i = 0; i < M; ++i) {
+      distinct += rep[i] == i;
+    }
+    REQUIRE(distinct <= patterns + 1);
+  }
+
+  SECTION("Product matches the plain multiply") {
+    for (int threads : {1, 3}) {
+      REQUIRE(A.dedupRowsMatmul(B, threads).getCoords() == expected);
+    }
+    // An operand with few or no duplicate rows
+    REQUIRE(B.transpose().dedupRowsMatmul(A.transpose(), 1).getCoords() ==
+            B.transpose().naiveMatmul(A.transpose()).getCoords());
+  }
+
+  SECTION("Dimension mismatch throws invalid_argument") {
+    REQUIRE_THROWS_AS(A.dedupRowsMatmul(A), std::invalid_argument);
+  }
+}
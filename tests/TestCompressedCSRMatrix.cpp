@@ -0,0 +1,97 @@
+#define CATCH_CONFIG_MAIN
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "../include/CSRMatrix.h"
+#include "../include/CompressedCSRMatrix.h"
+#include "../include/GraphTraversal.h"
+#include "../include/MatrixUtils.h"
+
+TEST_CASE("CompressedCSRMatrix encoding", "[CompressedCSRMatrix]") {
+  SECTION("Round trip keeps clustered and far-apart columns") {
+    // Columns past 65535 and gaps of exactly 0xFFFF need the escape
+    int M = 4, N = 300000;
+    std::vector<Coord> coords = {{0, 0},     {0, 1},      {0, 65535},
+                                 {0, 65536}, {0, 299999}, {2, 70000},
+                                 {3, 5},     {3, 65540}};
+    CSRMatrix csr(coords, M, N);
+    CompressedCSRMatrix compressed(csr);
+    REQUIRE(compressed.shape() == std::pair<int, int>(M, N));
+    REQUIRE(compressed.nnz() == coords.size());
+    REQUIRE(compressed.toCSR().getCoords() == csr.getCoords());
+  }
+
+  SECTION("Clustered rows take half the index bytes") {
+    int M = 300, N = 5000;
+    CSRMatrix csr(generateSparseMatrix(0.02, M, N, 1), M, N);
+    CompressedCSRMatrix compressed(csr);
+    REQUIRE(compressed.indexBytes() == csr.getColIdx().size() * 2);
+    REQUIRE(compressed.toCSR().getColIdx() == csr.getColIdx());
+    REQUIRE(compressed.toCSR().getRowPtr() == csr.getRowPtr());
+  }
+}
+
+TEST_CASE("CompressedCSRMatrix kernels", "[CompressedCSRMatrix]") {
+  int M = 120, K = 90000, N = 140;
+  auto coordsA = generateSparseMatrix(0.0002, M, K, 1);
+  auto coordsB = generateSparseMatrix(0.03, K, N, 2);
+  CSRMatrix A(coordsA, M, K);
+  CSRMatrix B(coordsB, K, N);
+  CompressedCSRMatrix cA(A), cB(B);
+
+  SECTION("Dimension errors thrown") {
+    REQUIRE_THROWS_AS(cA.naiveMatmul(cA), std::invalid_argument);
+    REQUIRE_THROWS_AS(cA.multiplyVector(std::vector<double>(M)),
+                      std::invalid_argument);
+  }
+
+  SECTION("Valued matrices are rejected") {
+    CSRMatrix valued(A.getRowPtr(), A.getColIdx(),
+                     std::vector<double>(A.getColIdx().size(), 2.0), M, K);
+    REQUIRE_THROWS_AS(CompressedCSRMatrix(valued), std::invalid_argument);
+  }
+
+  SECTION("naiveMatmul matches CSR") {
+    CSRMatrix C = cA.naiveMatmul(cB);
+    REQUIRE(C.shape() == std::pair<int, int>(M, N));
+    REQUIRE(C.getCoords() == A.naiveMatmul(B).getCoords());
+  }
+
+  SECTION("multiplyVector matches CSR") {
+    std::vector<double> x(K);
+    for (int j = 0; j < K; ++j) {
+      x[j] = j % 13;
+    }
+    REQUIRE(cA.multiplyVector(x) == A.multiplyVector(x));
+  }
+
+  SECTION("vectorMatmul matches CSR") {
+    // Few rows take the marker path, many rows the bitmap path
+    std::vector<int> few = {3, 50}, many;
+    for (int j = 0; j < K; j += 7) {
+      many.push_back(j);
+    }
+    REQUIRE(cB.vectorMatmul(few) == vectorMatmul(few, B));
+    REQUIRE(cB.vectorMatmul(many) == vectorMatmul(many, B));
+    REQUIRE(cA.vectorMatmul({0, 7, M - 1}) == vectorMatmul({0, 7, M - 1}, A));
+    REQUIRE_THROWS_AS(cA.vectorMatmul({M}), std::out_of_range);
+  }
+}
+
+TEST_CASE("CompressedCSRMatrix bfsLevels", "[CompressedCSRMatrix]") {
+  int n = 70000;
+  CSRMatrix G(generateSparseMatrix(0.00005, n, n, 3), n, n);
+  CompressedCSRMatrix cG(G);
+
+  SECTION("Levels match the CSR search") {
+    REQUIRE(cG.bfsLevels(0) == bfsLevels(G, 0));
+    REQUIRE(cG.bfsLevels(n - 1) == bfsLevels(G, n - 1));
+  }
+
+  SECTION("Errors thrown") {
+    CompressedCSRMatrix rect(CSRMatrix({{0, 1}}, 2, 3));
+    REQUIRE_THROWS_AS(rect.bfsLevels(0), std::invalid_argument);
+    REQUIRE_THROWS_AS(cG.bfsLevels(n), std::out_of_range);
+    REQUIRE_THROWS_AS(cG.bfsLevels(-1), std::out_of_range);
+  }
+}
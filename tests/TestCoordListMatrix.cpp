@@ -317,4 +317,51 @@ TEST_CASE("CoordListMatrix batched optimized matmul", "[CoordListMatrix]") {
       }
     }
   }
-}
\ No newline at end of file
+}
+
+TEST_CASE("CoordListMatrix batched parallel matmul", "[CoordListMatrix]") {
+  double sparsity = 0.01;
+  int N = 100;
+
+  SECTION("Dimension error thrown") {
+    CoordListMatrix A(generateSparseMatrix(sparsity, N, N, 1), N, N);
+
+    // First right matrix is valid, second has mismatched dimensions
+    std::vector<CoordListMatrix> rights;
+    rights.emplace_back(generateSparseMatrix(sparsity, N, N, 2), N, N);
+    rights.emplace_back(generateSparseMatrix(sparsity, N + 1, N, 3), N + 1,
+                        N); // Invalid
+
+    REQUIRE_THROWS_AS(A.batchParallelMatmul(rights), std::invalid_argument);
+  }
+
+  SECTION("Correctness check, uneven batch") {
+    CoordListMatrix A(generateSparseMatrix(sparsity, N, N, 1), N, N);
+
+    // Right-hand matrices of very different density and width
+    std::vector<CoordListMatrix> rights;
+    rights.emplace_back(generateSparseMatrix(0.2, N, 3 * N, 100), N, 3 * N);
+    rights.emplace_back(generateSparseMatrix(0.01, N, 7, 101), N, 7);
+    rights.emplace_back(generateSparseMatrix(0.05, N, N, 102), N, N);
+
+    auto results = A.batchParallelMatmul(rights, 3);
+
+    REQUIRE(results.size() == rights.size());
+
+    auto coordSorter = [](const Coord &a, const Coord &b) {
+      return (a.row != b.row) ? (a.row < b.row) : (a.col < b.col);
+    };
+
+    for (size_t i = 0; i < rights.size(); ++i) {
+      CoordListMatrix expected = A.naiveMatmul(rights[i]);
+      REQUIRE(results[i].shape() == expected.shape());
+
+      auto expectedCoords = expected.getCoords();
+      auto actualCoords = results[i].getCoords();
+      std::sort(expectedCoords.begin(), expectedCoords.end(), coordSorter);
+      std::sort(actualCoords.begin(), actualCoords.end(), coordSorter);
+
+      REQUIRE(expectedCoords == actualCoords);
+    }
+  }
+}
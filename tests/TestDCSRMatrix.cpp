@@ -0,0 +1,96 @@
+#define CATCH_CONFIG_MAIN
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "../include/CSRMatrix.h"
+#include "../include/DCSRMatrix.h"
+#include <algorithm>
+#include <random>
+
+// Random entries confined to about nnz / 8 rows, so most rows are empty
+static std::vector<Coord> hypersparseCoords(int M, int N, int nnz, int seed) {
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<int> rowDist(0, M - 1), colDist(0, N - 1);
+  std::vector<int> rows(nnz / 8 + 1);
+  for (int &row : rows) {
+    row = rowDist(rng);
+  }
+  std::vector<Coord> coords;
+  for (int i = 0; i < nnz; ++i) {
+    coords.push_back({rows[i % rows.size()], colDist(rng)});
+  }
+  std::sort(coords.begin(), coords.end(), [](const Coord &a, const Coord &b) {
+    return a.row != b.row ? a.row < b.row : a.col < b.col;
+  });
+  coords.erase(std::unique(coords.begin(), coords.end()), coords.end());
+  return coords;
+}
+
+TEST_CASE("DCSRMatrix conversions", "[DCSRMatrix]") {
+  int M = 5000, N = 300;
+  auto coords = hypersparseCoords(M, N, 400, 1);
+  CSRMatrix csr(coords, M, N);
+
+  SECTION("Errors thrown") {
+    REQUIRE_THROWS_AS(DCSRMatrix(coords, 0, N), std::invalid_argument);
+    REQUIRE_THROWS_AS(DCSRMatrix({{M, 0}}, M, N), std::out_of_range);
+    REQUIRE_THROWS_AS(CSRMatrix(std::vector<int>{0, 1}, {}, 1, 1),
+                      std::invalid_argument);
+    CSRMatrix valued(csr.getRowPtr(), csr.getColIdx(),
+                     std::vector<double>(csr.getColIdx().size(), 2.0), M, N);
+    REQUIRE_THROWS_AS(DCSRMatrix(valued), std::invalid_argument);
+  }
+
+  SECTION("Only non-empty rows are stored") {
+    DCSRMatrix fromCsr(csr);
+    DCSRMatrix fromCoords(coords, M, N);
+    REQUIRE(fromCsr.shape() == std::pair<int, int>(M, N));
+    REQUIRE(fromCsr.getRowIds() == fromCoords.getRowIds());
+    REQUIRE(fromCsr.getRowPtr() == fromCoords.getRowPtr());
+    REQUIRE(fromCsr.getColIdx() == fromCoords.getColIdx());
+    REQUIRE(fromCsr.getRowIds().size() < static_cast<size_t>(M / 10));
+    REQUIRE(fromCsr.getRowPtr().size() == fromCsr.getRowIds().size() + 1);
+  }
+
+  SECTION("Round trip through CSR is lossless") {
+    CSRMatrix back = DCSRMatrix(csr).toCSR();
+    REQUIRE(back.shape() == csr.shape());
+    REQUIRE(back.getRowPtr() == csr.getRowPtr());
+    REQUIRE(back.getColIdx() == csr.getColIdx());
+    REQUIRE(DCSRMatrix(csr).getCoords() == csr.getCoords());
+  }
+}
+
+TEST_CASE("DCSRMatrix naiveMatmul", "[DCSRMatrix]") {
+  SECTION("Dimension errors thrown") {
+    DCSRMatrix A(hypersparseCoords(100, 50, 40, 1), 100, 50);
+    REQUIRE_THROWS_AS(A.naiveMatmul(A), std::invalid_argument);
+  }
+
+  SECTION("Matches CSR for both accumulators") {
+    // Narrow products use the marker array, very wide ones sort-and-unique
+    for (int N : {200, 2000000}) {
+      int M = 3000, K = 2500;
+      auto coordsA = hypersparseCoords(M, K, 300, 2);
+      auto coordsB = hypersparseCoords(K, N, 300, 3);
+      // Make sure some of A's columns hit B's stored rows
+      for (const Coord &c : coordsA) {
+        coordsB.push_back({c.col, (c.row * 31) % N});
+      }
+      std::sort(coordsB.begin(), coordsB.end(),
+                [](const Coord &a, const Coord &b) {
+                  return a.row != b.row ? a.row < b.row : a.col < b.col;
+                });
+      coordsB.erase(std::unique(coordsB.begin(), coordsB.end()),
+                    coordsB.end());
+
+      auto expected =
+          CSRMatrix(coordsA, M, K).naiveMatmul(CSRMatrix(coordsB, K, N));
+      DCSRMatrix C =
+          DCSRMatrix(coordsA, M, K).naiveMatmul(DCSRMatrix(coordsB, K, N));
+      REQUIRE(C.shape() == std::pair<int, int>(M, N));
+      REQUIRE_FALSE(C.getCoords().empty());
+      REQUIRE(C.getCoords() == expected.getCoords());
+    }
+  }
+}
@@ -0,0 +1,57 @@
+#define CATCH_CONFIG_MAIN
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "../include/CSRMatrix.h"
+#include "../include/DenseBitMatrix.h"
+#include "../include/MatrixUtils.h"
+
+TEST_CASE("DenseBitMatrix basics", "[DenseBitMatrix]") {
+  DenseBitMatrix D(3, 70);
+  REQUIRE(D.nnz() == 0);
+  D.set(1, 65);
+  D.set(2, 0);
+  REQUIRE(D.get(1, 65));
+  REQUIRE_FALSE(D.get(1, 64));
+  REQUIRE(D.nnz() == 2);
+  REQUIRE(D.toCSR().getCoords() == std::vector<Coord>{{1, 65}, {2, 0}});
+  REQUIRE_THROWS_AS(D.get(3, 0), std::out_of_range);
+  REQUIRE_THROWS_AS(D.set(0, 70), std::out_of_range);
+  REQUIRE_THROWS_AS(DenseBitMatrix(-1, 2), std::invalid_argument);
+
+  CSRMatrix A(generateSparseMatrix(0.1, 50, 130, 1), 50, 130);
+  REQUIRE(DenseBitMatrix(A).toCSR().getCoords() == A.getCoords());
+  CSRMatrix valued(A.getRowPtr(), A.getColIdx(),
+                   std::vector<double>(A.getColIdx().size(), 2.0), 50, 130);
+  REQUIRE_THROWS_AS(DenseBitMatrix(valued), std::invalid_argument);
+  REQUIRE_THROWS_AS(DenseBitMatrix::scatterProduct(valued, A.transpose()),
+                    std::invalid_argument);
+}
+
+TEST_CASE("DenseBitMatrix Four Russians multiply", "[DenseBitMatrix]") {
+  SECTION("Dimension errors thrown") {
+    DenseBitMatrix A(4, 5), B(6, 4);
+    REQUIRE_THROWS_AS(A.naiveMatmul(B), std::invalid_argument);
+  }
+
+  SECTION("Matches CSR across densities and ragged shapes") {
+    // K = 131 leaves a partial last group of columns
+    int M = 97, K = 131, N = 203;
+    for (double density : {0.01, 0.05, 0.3}) {
+      CSRMatrix A(generateSparseMatrix(density, M, K, 2), M, K);
+      CSRMatrix B(generateSparseMatrix(density, K, N, 3), K, N);
+      DenseBitMatrix C = DenseBitMatrix(A).naiveMatmul(DenseBitMatrix(B));
+      REQUIRE(C.shape() == std::pair<int, int>(M, N));
+      REQUIRE(C.toCSR().getCoords() == A.naiveMatmul(B).getCoords());
+    }
+  }
+
+  SECTION("optimizedMatmul switches to the dense kernel on dense estimates") {
+    int M = 80, K = 90, N = 100;
+    CSRMatrix A(generateSparseMatrix(0.2, M, K, 4), M, K);
+    CSRMatrix B(generateSparseMatrix(0.2, K, N, 5), K, N);
+    auto expected = A.naiveMatmul(B).getCoords();
+    REQUIRE(A.optimizedMatmul(B, 0.9 * M * N).getCoords() == expected);
+    REQUIRE(A.optimizedMatmul(B, 1.0).getCoords() == expected);
+  }
+}
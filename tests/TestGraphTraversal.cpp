@@ -0,0 +1,116 @@
+#define CATCH_CONFIG_MAIN
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "../include/CSRMatrix.h"
+#include "../include/GraphTraversal.h"
+#include "../include/MatrixUtils.h"
+#include <queue>
+
+// Plain queue-based BFS to check against
+static std::vector<int> referenceBfs(const CSRMatrix &adjacency, int source) {
+  const auto &rowPtr = adjacency.getRowPtr();
+  const auto &colIdx = adjacency.getColIdx();
+  std::vector<int> levels(adjacency.shape().first, -1);
+  std::queue<int> queue;
+  levels[source] = 0;
+  queue.push(source);
+  while (!queue.empty()) {
+    const int u = queue.front();
+    queue.pop();
+    for (int p = rowPtr[u]; p < rowPtr[u + 1]; ++p) {
+      if (levels[colIdx[p]] < 0) {
+        levels[colIdx[p]] = levels[u] + 1;
+        queue.push(colIdx[p]);
+      }
+    }
+  }
+  return levels;
+}
+
+TEST_CASE("Sparse vector products", "[GraphTraversal]") {
+  int M = 90, N = 700;
+  CSRMatrix A(generateSparseMatrix(0.02, M, N, 1), M, N);
+
+  SECTION("vectorMatmul matches a 1 x M matrix product") {
+    for (std::vector<int> x :
+         {std::vector<int>{}, std::vector<int>{4}, std::vector<int>{1, 7, 30},
+          std::vector<int>{0, 5, 10, 20, 40, 50, 60, 70, 80, 89}}) {
+      std::vector<Coord> coords;
+      for (int i : x) {
+        coords.push_back({0, i});
+      }
+      std::vector<int> expected;
+      for (const Coord &c : CSRMatrix(coords, 1, M).naiveMatmul(A).getCoords()) {
+        expected.push_back(c.col);
+      }
+      REQUIRE(vectorMatmul(x, A) == expected);
+    }
+    REQUIRE_THROWS_AS(vectorMatmul({M}, A), std::out_of_range);
+  }
+
+  SECTION("matrixVectorMatmul matches an N x 1 matrix product") {
+    std::vector<int> x = {3, 64, 65, 200, 511, 699};
+    std::vector<Coord> coords;
+    for (int j : x) {
+      coords.push_back({j, 0});
+    }
+    std::vector<int> expected;
+    for (const Coord &c : A.naiveMatmul(CSRMatrix(coords, N, 1)).getCoords()) {
+      expected.push_back(c.row);
+    }
+    REQUIRE(matrixVectorMatmul(A, x) == expected);
+    REQUIRE(matrixVectorMatmul(A, {}).empty());
+    REQUIRE_THROWS_AS(matrixVectorMatmul(A, {-1}), std::out_of_range);
+  }
+
+  SECTION("Valued matrices are rejected") {
+    CSRMatrix valued(A.getRowPtr(), A.getColIdx(),
+                     std::vector<double>(A.getColIdx().size(), 2.0), M, N);
+    REQUIRE_THROWS_AS(vectorMatmul({1}, valued), std::invalid_argument);
+    REQUIRE_THROWS_AS(matrixVectorMatmul(valued, {3}), std::invalid_argument);
+  }
+}
+
+TEST_CASE("Breadth-first search", "[GraphTraversal]") {
+  int n = 400;
+
+  SECTION("Errors thrown") {
+    CSRMatrix rect(generateSparseMatrix(0.01, n, n + 1, 1), n, n + 1);
+    REQUIRE_THROWS_AS(bfsLevels(rect, 0), std::invalid_argument);
+    CSRMatrix G(generateSparseMatrix(0.01, n, n, 1), n, n);
+    REQUIRE_THROWS_AS(bfsLevels(G, n), std::out_of_range);
+    REQUIRE_THROWS_AS(multiSourceBfsLevels(G, {0, n}), std::out_of_range);
+  }
+
+  SECTION("Single source matches a queue BFS on sparse and dense graphs") {
+    // The sparse graph stays in push mode; the dense one switches to pull
+    for (double density : {0.004, 0.05}) {
+      CSRMatrix G(generateSparseMatrix(density, n, n, 2), n, n);
+      for (int source : {0, 17, 399}) {
+        REQUIRE(bfsLevels(G, source) == referenceBfs(G, source));
+      }
+    }
+  }
+
+  SECTION("Weighted adjacency is searched by its pattern") {
+    // Dense enough to switch to pull, which transposes the adjacency
+    CSRMatrix G(generateSparseMatrix(0.05, n, n, 2), n, n);
+    CSRMatrix weighted(G.getRowPtr(), G.getColIdx(),
+                       std::vector<double>(G.getColIdx().size(), 0.5), n, n);
+    REQUIRE(bfsLevels(weighted, 17) == referenceBfs(G, 17));
+  }
+
+  SECTION("Multi-source matches single-source runs across batches") {
+    CSRMatrix G(generateSparseMatrix(0.006, n, n, 3), n, n);
+    std::vector<int> sources;
+    for (int s = 0; s < 70; ++s) {
+      sources.push_back((s * 37) % n);
+    }
+    auto levels = multiSourceBfsLevels(G, sources);
+    REQUIRE(levels.size() == sources.size());
+    for (size_t s = 0; s < sources.size(); ++s) {
+      REQUIRE(levels[s] == referenceBfs(G, sources[s]));
+    }
+  }
+}
@@ -0,0 +1,189 @@
+#define CATCH_CONFIG_MAIN
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "../include/CSRMatrix.h"
+#include "../include/MatrixUtils.h"
+#include "../include/ProductPlanner.h"
+#include <thread>
+
+TEST_CASE("chooseProductFormat", "[ProductPlanner]") {
+  // 1000 x 1000 product: 1e6 cells
+  REQUIRE(chooseProductFormat(500, 1000, 1000) == ProductFormat::Hypersparse);
+  REQUIRE(chooseProductFormat(5000, 1000, 1000) == ProductFormat::CSR);
+  REQUIRE(chooseProductFormat(40000, 1000, 1000) ==
+          ProductFormat::BitmapRows);
+  REQUIRE(chooseProductFormat(300000, 1000, 1000) == ProductFormat::Dense);
+  REQUIRE(chooseProductFormat(10, 0, 0) == ProductFormat::CSR);
+  // Tall and narrow: fewer entries than rows, yet 22.5% dense
+  REQUIRE(chooseProductFormat(9e5, 1000000, 4) == ProductFormat::Dense);
+  REQUIRE(chooseProductFormat(50, 1000000, 4) == ProductFormat::Hypersparse);
+  REQUIRE(std::string(toString(ProductFormat::BitmapRows)) == "bitmap-rows");
+}
+
+TEST_CASE("multiplyAs", "[ProductPlanner]") {
+  int M = 120, K = 100, N = 140;
+  CSRMatrix A(generateSparseMatrix(0.03, M, K, 1), M, K);
+  CSRMatrix B(generateSparseMatrix(0.03, K, N, 2), K, N);
+  auto expected = A.naiveMatmul(B).getCoords();
+
+  SECTION("Dimension errors thrown") {
+    REQUIRE_THROWS_AS(multiplyAs(A, A, ProductFormat::Dense),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(DenseBitMatrix::scatterProduct(A, A),
+                      std::invalid_argument);
+  }
+
+  SECTION("Every format holds the same product in its own type") {
+    auto csr = multiplyAs(A, B, ProductFormat::CSR);
+    auto hyper = multiplyAs(A, B, ProductFormat::Hypersparse);
+    auto bitmap = multiplyAs(A, B, ProductFormat::BitmapRows);
+    auto dense = multiplyAs(A, B, ProductFormat::Dense);
+
+    REQUIRE(std::holds_alternative<CSRMatrix>(csr));
+    REQUIRE(std::holds_alternative<DCSRMatrix>(hyper));
+    REQUIRE(std::holds_alternative<DenseBitMatrix>(bitmap));
+    REQUIRE(std::holds_alternative<DenseBitMatrix>(dense));
+    for (const auto *product : {&csr, &hyper, &bitmap, &dense}) {
+      REQUIRE(toCSR(*product).getCoords() == expected);
+    }
+  }
+
+  SECTION("multiplyToEstimatedFormat follows the estimate") {
+    REQUIRE(std::holds_alternative<DCSRMatrix>(
+        multiplyToEstimatedFormat(A, B, 1.0)));
+    REQUIRE(std::holds_alternative<CSRMatrix>(
+        multiplyToEstimatedFormat(A, B, 0.01 * M * N)));
+    REQUIRE(std::holds_alternative<DenseBitMatrix>(
+        multiplyToEstimatedFormat(A, B, 0.5 * M * N)));
+    REQUIRE(toCSR(multiplyToEstimatedFormat(A, B, 0.04 * M * N)).getCoords() ==
+            expected);
+  }
+
+  SECTION("Dense product over a long inner dimension") {
+    // Every row of L picks one of 20 full rows of R: a fully dense 2000 x 20
+    // product whose left operand would pack to 50 MB
+    int rows = 2000, inner = 200000, cols = 20;
+    std::vector<Coord> left, right;
+    for (int i = 0; i < rows; ++i) {
+      left.push_back({i, (i % cols) * 10000});
+    }
+    for (int j = 0; j < cols; ++j) {
+      for (int k = 0; k < cols; ++k) {
+        right.push_back({j * 10000, k});
+      }
+    }
+    CSRMatrix L(left, rows, inner);
+    CSRMatrix R(right, inner, cols);
+    auto dense = multiplyAs(L, R, ProductFormat::Dense);
+    REQUIRE(std::holds_alternative<DenseBitMatrix>(dense));
+    REQUIRE(std::get<DenseBitMatrix>(dense).nnz() ==
+            static_cast<size_t>(rows * cols));
+    REQUIRE(L.optimizedMatmul(R, rows * cols).getCoords() ==
+            L.naiveMatmul(R).getCoords());
+  }
+}
+
+TEST_CASE("planProduct", "[ProductPlanner]") {
+  ProductStats stats;
+  stats.rows = stats.inner = stats.cols = 100000;
+
+  SECTION("Non-CSR formats take their native kernels") {
+    stats.flops = 1000;
+    stats.estimatedNnz = 500;
+    REQUIRE(planProduct(stats).kernel == Kernel::Hypersparse);
+    stats.rows = stats.cols = 1000;
+    stats.flops = 1 << 20;
+    stats.estimatedNnz = 300000;
+    REQUIRE(planProduct(stats).kernel == Kernel::Dense);
+  }
+
+  SECTION("Small CSR products stay sequential") {
+    stats.flops = 1 << 17;
+    stats.estimatedNnz = 120000;
+    stats.compressionRatio = stats.flops / stats.estimatedNnz;
+    Plan plan = planProduct(stats);
+    REQUIRE(plan.kernel == Kernel::Gustavson);
+    REQUIRE(plan.numThreads == 1);
+
+    // A caller-given thread count overrides the flop rule
+    plan = planProduct(stats, 4);
+    REQUIRE(plan.kernel == Kernel::OuterProduct);
+    REQUIRE(plan.numThreads == 4);
+  }
+
+  SECTION("Large CSR products split by flops and compression") {
+    if (std::thread::hardware_concurrency() > 1) {
+      stats.flops = int64_t{1} << 24;
+      stats.estimatedNnz = double(int64_t{1} << 24) / 4;
+      stats.compressionRatio = 4;
+      Plan plan = planProduct(stats);
+      REQUIRE(plan.kernel == Kernel::ParallelRowWise);
+      REQUIRE(plan.numThreads > 1);
+
+      stats.estimatedNnz = double(int64_t{1} << 24) / 1.2;
+      stats.compressionRatio = 1.2;
+      REQUIRE(planProduct(stats).kernel == Kernel::OuterProduct);
+    }
+  }
+}
+
+TEST_CASE("multiply", "[ProductPlanner]") {
+  int M = 150, K = 120, N = 130;
+  CSRMatrix A(generateSparseMatrix(0.04, M, K, 5), M, K);
+  CSRMatrix B(generateSparseMatrix(0.04, K, N, 6), K, N);
+  auto expected = A.naiveMatmul(B).getCoords();
+
+  std::vector<std::string> lines;
+  setPlanLogger([&](const std::string &line) { lines.push_back(line); });
+
+  SECTION("Statistics match the operands") {
+    ProductStats stats = gatherProductStats(A, B);
+    REQUIRE(stats.nnzA == static_cast<int64_t>(A.getColIdx().size()));
+    REQUIRE(stats.flops >= static_cast<int64_t>(expected.size()));
+    REQUIRE(stats.maxRowFlops <= stats.flops);
+    int rowsCounted = 0;
+    for (int count : stats.rowLengthHistogram) {
+      rowsCounted += count;
+    }
+    REQUIRE(rowsCounted == M);
+    REQUIRE(stats.estimatedNnz > 0);
+    REQUIRE_THROWS_AS(gatherProductStats(A, A), std::invalid_argument);
+  }
+
+  SECTION("Every kernel gives the same product") {
+    for (Kernel kernel :
+         {Kernel::Auto, Kernel::Gustavson, Kernel::ParallelRowWise,
+          Kernel::OuterProduct, Kernel::Hypersparse, Kernel::BitmapRows,
+          Kernel::Dense}) {
+      REQUIRE(toCSR(multiply(A, B, Plan{kernel, 2})).getCoords() == expected);
+    }
+    REQUIRE(lines.size() == 7);
+    REQUIRE(lines[0].find("flops=") != std::string::npos);
+    REQUIRE(lines[1].find("explicit -> gustavson") != std::string::npos);
+  }
+
+  SECTION("Thread counts resolve for explicit and auto plans") {
+    toCSR(multiply(A, B, Plan{Kernel::ParallelRowWise, 0}));
+    toCSR(multiply(A, B, Plan{Kernel::Gustavson, 4}));
+    REQUIRE(lines.size() == 2);
+    REQUIRE(lines[0].find("parallel-row-wise threads=0") == std::string::npos);
+    REQUIRE(lines[1].find("gustavson threads=1") != std::string::npos);
+  }
+
+  SECTION("Dimension mismatch throws before logging") {
+    REQUIRE_THROWS_AS(multiply(A, A), std::invalid_argument);
+    REQUIRE(lines.empty());
+  }
+
+  SECTION("Valued operands throw before logging") {
+    CSRMatrix valued(A.getRowPtr(), A.getColIdx(),
+                     std::vector<double>(A.getColIdx().size(), 2.0), M, K);
+    REQUIRE_THROWS_AS(multiply(valued, B), std::invalid_argument);
+    REQUIRE_THROWS_AS(multiplyAs(valued, B, ProductFormat::BitmapRows),
+                      std::invalid_argument);
+    REQUIRE(lines.empty());
+  }
+
+  setPlanLogger(nullptr);
+}
@@ -0,0 +1,178 @@
+#define CATCH_CONFIG_MAIN
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "../include/CSRMatrix.h"
+#include "../include/MatrixUtils.h"
+#include "../include/Reordering.h"
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+static bool isPermutation(std::vector<int> perm, int n) {
+  std::vector<int> identity(n);
+  std::iota(identity.begin(), identity.end(), 0);
+  std::sort(perm.begin(), perm.end());
+  return perm == identity;
+}
+
+static int bandwidth(const CSRMatrix &A) {
+  const auto &rowPtr = A.getRowPtr();
+  const auto &colIdx = A.getColIdx();
+  int width = 0;
+  for (int r = 0; r < A.shape().first; ++r) {
+    for (int p = rowPtr[r]; p < rowPtr[r + 1]; ++p) {
+      width = std::max(width, std::abs(colIdx[p] - r));
+    }
+  }
+  return width;
+}
+
+static std::vector<int> shuffled(int n, int seed) {
+  std::vector<int> perm(n);
+  std::iota(perm.begin(), perm.end(), 0);
+  std::shuffle(perm.begin(), perm.end(), std::mt19937(seed));
+  return perm;
+}
+
+TEST_CASE("Permutations", "[Reordering]") {
+  int n = 90;
+  CSRMatrix A(generateSparseMatrix(0.05, n, n, 1), n, n);
+
+  SECTION("Invalid permutations throw invalid_argument") {
+    REQUIRE_THROWS_AS(invertPermutation({0, 2, 2}), std::invalid_argument);
+    REQUIRE_THROWS_AS(invertPermutation({0, 3, 1}), std::invalid_argument);
+    REQUIRE_THROWS_AS(permuteSymmetric(A, shuffled(n - 1, 1)),
+                      std::invalid_argument);
+    CSRMatrix R(generateSparseMatrix(0.05, n, n + 5, 2), n, n + 5);
+    REQUIRE_THROWS_AS(permuteSymmetric(R, shuffled(n, 1)),
+                      std::invalid_argument);
+  }
+
+  SECTION("Symmetric permutation matches the definition and round trips") {
+    auto perm = shuffled(n, 3);
+    auto inverse = invertPermutation(perm);
+    for (int threads : {1, 3}) {
+      CSRMatrix B = permuteSymmetric(A, perm, threads);
+      std::vector<Coord> expected;
+      for (const auto &[r, c] : A.getCoords()) {
+        expected.push_back({inverse[r], inverse[c]});
+      }
+      std::sort(expected.begin(), expected.end(),
+                [](const Coord &a, const Coord &b) {
+                  return a.row != b.row ? a.row < b.row : a.col < b.col;
+                });
+      REQUIRE(B.getCoords() == expected);
+      REQUIRE(permuteSymmetric(B, inverse, threads).getCoords() ==
+              A.getCoords());
+    }
+  }
+
+  SECTION("Values move with their entries") {
+    CSRMatrix V({0, 2, 3}, {0, 1, 0}, {1.0, 2.0, 3.0}, 2, 2);
+    CSRMatrix P = permuteSymmetric(V, {1, 0});
+    REQUIRE(P.getRowPtr() == std::vector<int>{0, 1, 3});
+    REQUIRE(P.getColIdx() == std::vector<int>{1, 0, 1});
+    REQUIRE(P.getValues() == std::vector<double>{3.0, 2.0, 1.0});
+  }
+}
+
+TEST_CASE("Orderings", "[Reordering]") {
+  SECTION("RCM recovers a narrow band from a shuffled path") {
+    int n = 200;
+    std::vector<Coord> path;
+    for (int i = 0; i + 1 < n; ++i) {
+      path.push_back({i, i + 1});
+      path.push_back({i + 1, i});
+    }
+    std::sort(path.begin(), path.end(), [](const Coord &a, const Coord &b) {
+      return a.row != b.row ? a.row < b.row : a.col < b.col;
+    });
+    CSRMatrix shuffledPath =
+        permuteSymmetric(CSRMatrix(path, n, n), shuffled(n, 4));
+    REQUIRE(bandwidth(shuffledPath) > 10);
+
+    auto perm = reverseCuthillMcKee(shuffledPath);
+    REQUIRE(isPermutation(perm, n));
+    REQUIRE(bandwidth(permuteSymmetric(shuffledPath, perm)) == 1);
+  }
+
+  SECTION("RCM covers every component and isolated vertex") {
+    int n = 150;
+    CSRMatrix A(generateSparseMatrix(0.005, n, n, 5), n, n);
+    REQUIRE(isPermutation(reverseCuthillMcKee(A), n));
+    REQUIRE_THROWS_AS(
+        reverseCuthillMcKee(CSRMatrix(generateSparseMatrix(0.1, 4, 5, 1), 4, 5)),
+        std::invalid_argument);
+  }
+
+  SECTION("Weighted matrices are ordered by their pattern") {
+    int n = 150;
+    CSRMatrix A(generateSparseMatrix(0.02, n, n, 5), n, n);
+    CSRMatrix weighted(A.getRowPtr(), A.getColIdx(),
+                       std::vector<double>(A.getColIdx().size(), 3.0), n, n);
+    REQUIRE(reverseCuthillMcKee(weighted) == reverseCuthillMcKee(A));
+    REQUIRE(clusterOrder(weighted) == clusterOrder(A));
+  }
+
+  SECTION("Degree order sorts rows by decreasing length") {
+    CSRMatrix A(generateSparseMatrix(0.05, 80, 60, 6), 80, 60);
+    auto perm = degreeOrder(A);
+    REQUIRE(isPermutation(perm, 80));
+    const auto &rowPtr = A.getRowPtr();
+    for (size_t i = 1; i < perm.size(); ++i) {
+      REQUIRE(rowPtr[perm[i - 1] + 1] - rowPtr[perm[i - 1]] >=
+              rowPtr[perm[i] + 1] - rowPtr[perm[i]]);
+    }
+  }
+
+  SECTION("Cluster order keeps disjoint cliques contiguous") {
+    // Two 6-cliques, interleaved by vertex id
+    int n = 12;
+    std::vector<Coord> coords;
+    for (int u = 0; u < n; ++u) {
+      for (int v = 0; v < n; ++v) {
+        if (u != v && u % 2 == v % 2) {
+          coords.push_back({u, v});
+        }
+      }
+    }
+    auto perm = clusterOrder(CSRMatrix(coords, n, n));
+    REQUIRE(isPermutation(perm, n));
+    for (int i = 0; i < n; ++i) {
+      REQUIRE(perm[i] % 2 == (i < n / 2 ? 0 : 1));
+    }
+  }
+}
+
+TEST_CASE("reorderedMatmul", "[Reordering]") {
+  int n = 120;
+  CSRMatrix A(generateSparseMatrix(0.04, n, n, 7), n, n);
+  CSRMatrix B(generateSparseMatrix(0.04, n, 70, 8), n, 70);
+  auto expected = A.naiveMatmul(B).getCoords();
+
+  SECTION("Every ordering gives the original product back") {
+    for (const auto &perm : {reverseCuthillMcKee(A), degreeOrder(A),
+                             clusterOrder(A), shuffled(n, 9)}) {
+      for (int threads : {1, 3}) {
+        REQUIRE(reorderedMatmul(A, B, perm, threads).getCoords() == expected);
+      }
+    }
+  }
+
+  SECTION("Rectangular left operand reorders rows only") {
+    CSRMatrix R(generateSparseMatrix(0.04, 50, n, 10), 50, n);
+    auto perm = degreeOrder(R);
+    REQUIRE(reorderedMatmul(R, B, perm).getCoords() ==
+            R.naiveMatmul(B).getCoords());
+
+    CSRMatrix kept = reorderedMatmul(R, B, perm, 1, false);
+    REQUIRE(permute(kept, invertPermutation(perm), {}).getCoords() ==
+            R.naiveMatmul(B).getCoords());
+  }
+
+  SECTION("Dimension mismatch throws invalid_argument") {
+    REQUIRE_THROWS_AS(reorderedMatmul(B, B, degreeOrder(B)),
+                      std::invalid_argument);
+  }
+}
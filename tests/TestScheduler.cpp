@@ -0,0 +1,93 @@
+#define CATCH_CONFIG_MAIN
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "../include/Scheduler.h"
+#include <atomic>
+#include <stdexcept>
+
+TEST_CASE("partitionRowsByWork", "[Scheduler]") {
+  SECTION("Mismatched work vector throws invalid_argument") {
+    std::vector<int> rowPtr = {0, 2, 3};
+    std::vector<int64_t> nnzWork = {1, 1};
+    REQUIRE_THROWS_AS(partitionRowsByWork(rowPtr, nnzWork, 2),
+                      std::invalid_argument);
+  }
+
+  SECTION("Balanced rows are packed without splitting") {
+    // 8 rows with 2 non-zeros of work 1 each
+    std::vector<int> rowPtr = {0, 2, 4, 6, 8, 10, 12, 14, 16};
+    std::vector<int64_t> nnzWork(16, 1);
+
+    auto chunks = partitionRowsByWork(rowPtr, nnzWork, 4);
+    REQUIRE(chunks.size() == 4);
+    for (const auto &chunk : chunks) {
+      CHECK(chunk.rowEnd - chunk.rowBegin == 2);
+      CHECK_FALSE(chunk.partialRow);
+    }
+  }
+
+  SECTION("Heavy row is split and chunks cover every non-zero once") {
+    // Row 1 holds most of the work
+    std::vector<int> rowPtr = {0, 1, 9, 10, 10};
+    std::vector<int64_t> nnzWork = {1, 5, 5, 5, 5, 5, 5, 5, 5, 1};
+
+    auto chunks = partitionRowsByWork(rowPtr, nnzWork, 4);
+
+    int nextRow = 0, nextPos = 0, heavyPieces = 0;
+    for (const auto &chunk : chunks) {
+      REQUIRE(chunk.aBegin == nextPos);
+      REQUIRE(chunk.rowBegin <= nextRow);
+      nextPos = chunk.aEnd;
+      nextRow = chunk.rowEnd;
+      if (chunk.partialRow) {
+        CHECK(chunk.rowBegin == 1);
+        heavyPieces++;
+      }
+    }
+    REQUIRE(nextPos == 10);
+    REQUIRE(nextRow == 4);
+    REQUIRE(heavyPieces > 1);
+  }
+}
+
+TEST_CASE("WorkStealingPool runAll", "[Scheduler]") {
+  WorkStealingPool pool(4);
+  REQUIRE(pool.size() == 4);
+
+  SECTION("Every task runs exactly once") {
+    std::vector<std::atomic<int>> hits(1000);
+    std::vector<std::function<void()>> tasks;
+    for (size_t i = 0; i < hits.size(); ++i) {
+      tasks.emplace_back([&hits, i] { hits[i]++; });
+    }
+    pool.runAll(tasks);
+
+    for (const auto &h : hits) {
+      REQUIRE(h.load() == 1);
+    }
+  }
+
+  SECTION("Nested runAll from inside a task completes") {
+    std::atomic<int> count{0};
+    std::vector<std::function<void()>> tasks;
+    for (int i = 0; i < 8; ++i) {
+      tasks.emplace_back([&] {
+        std::vector<std::function<void()>> inner;
+        for (int j = 0; j < 8; ++j) {
+          inner.emplace_back([&] { count++; });
+        }
+        pool.runAll(inner);
+      });
+    }
+    pool.runAll(tasks);
+    REQUIRE(count.load() == 64);
+  }
+
+  SECTION("Task exceptions are rethrown") {
+    std::vector<std::function<void()>> tasks;
+    tasks.emplace_back([] {});
+    tasks.emplace_back([] { throw std::runtime_error("task failed"); });
+    REQUIRE_THROWS_AS(pool.runAll(tasks), std::runtime_error);
+  }
+}
@@ -0,0 +1,92 @@
+#define CATCH_CONFIG_MAIN
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "../include/CSRMatrix.h"
+#include "../include/MatrixUtils.h"
+#include "../include/SellMatrix.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+static std::vector<double> randomVector(int n, int seed) {
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<int> dist(-50, 50);
+  std::vector<double> x(n);
+  for (double &v : x) {
+    v = dist(rng);
+  }
+  return x;
+}
+
+TEST_CASE("SellMatrix SpMV", "[SellMatrix]") {
+  int M = 203, N = 171;
+  // Row lengths vary widely, so chunks and windows see real padding
+  auto coords = generateSparseMatrix(0.03, M, N, 1);
+  for (int j = 0; j < N; j += 2) {
+    coords.push_back({7, j});
+  }
+  CSRMatrix A(coords, M, N);
+  auto x = randomVector(N, 2);
+  auto expected = A.multiplyVector(x);
+
+  SECTION("Errors thrown") {
+    REQUIRE_THROWS_AS(SellMatrix(A, 0, 8), std::invalid_argument);
+    REQUIRE_THROWS_AS(SellMatrix(A, 8, 12), std::invalid_argument);
+    REQUIRE_THROWS_AS(SellMatrix(A).multiplyVector(randomVector(N + 1, 3)),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(A.multiplyVector(randomVector(N - 1, 3)),
+                      std::invalid_argument);
+    CSRMatrix valued(A.getRowPtr(), A.getColIdx(),
+                     std::vector<double>(A.getColIdx().size(), 2.0), M, N);
+    REQUIRE_THROWS_AS(SellMatrix(valued), std::invalid_argument);
+  }
+
+  SECTION("Matches CSR SpMV for every C and sigma") {
+    for (auto [c, sigma] : {std::pair{1, 1}, std::pair{4, 4}, std::pair{8, 64},
+                            std::pair{8, 256}, std::pair{6, 30},
+                            std::pair{16, 512}}) {
+      SellMatrix S(A, c, sigma);
+      REQUIRE(S.shape() == A.shape());
+      REQUIRE(S.storedSlots() >= A.getColIdx().size());
+      // Integer-valued sums are exact in any order
+      REQUIRE(S.multiplyVector(x) == expected);
+    }
+  }
+
+  SECTION("Sorting within larger windows reduces padding") {
+    REQUIRE(SellMatrix(A, 8, 256).storedSlots() <=
+            SellMatrix(A, 8, 8).storedSlots());
+  }
+}
+
+TEST_CASE("SellMatrix vs CSR SpMV on data matrices", "[benchmark]") {
+  constexpr int kRepeats = 200;
+  for (const std::string file :
+       {"bwm200.mtx", "rdb200.mtx", "Trec4.mtx", "Trec5.mtx"}) {
+    CSRMatrix A(file);
+    SellMatrix S(A);
+    auto x = randomVector(A.shape().second, 1);
+
+    auto time = [&](auto &&spmv) {
+      const auto start = std::chrono::steady_clock::now();
+      for (int r = 0; r < kRepeats; ++r) {
+        spmv();
+      }
+      const auto end = std::chrono::steady_clock::now();
+      return std::chrono::duration<double>(end - start).count() / kRepeats;
+    };
+    std::vector<double> yCsr, ySell;
+    const double csrTime = time([&] { yCsr = A.multiplyVector(x); });
+    const double sellTime = time([&] { ySell = S.multiplyVector(x); });
+    REQUIRE(ySell == yCsr);
+
+    std::cout << std::fixed << std::setprecision(9);
+    std::cout << std::left << std::setw(12) << file << std::right
+              << "  nnz=" << std::setw(7) << A.getColIdx().size()
+              << "  slots=" << std::setw(7) << S.storedSlots()
+              << "  csr=" << std::setw(12) << csrTime << " s"
+              << "  sell=" << std::setw(12) << sellTime << " s" << std::endl;
+  }
+}
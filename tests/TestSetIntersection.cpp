@@ -0,0 +1,70 @@
+#define CATCH_CONFIG_MAIN
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "../include/SetIntersection.h"
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <vector>
+
+static std::vector<int> randomSortedSet(int size, int universe, int seed) {
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<int> dist(0, universe - 1);
+  std::vector<int> values;
+  for (int i = 0; i < size; ++i) {
+    values.push_back(dist(rng));
+  }
+  std::sort(values.begin(), values.end());
+  values.erase(std::unique(values.begin(), values.end()), values.end());
+  return values;
+}
+
+TEST_CASE("intersectSorted", "[SetIntersection]") {
+  SECTION("Empty and disjoint ranges") {
+    std::vector<int> a = {1, 3, 5, 7, 9};
+    std::vector<int> b = {0, 2, 4, 6, 8, 10};
+    REQUIRE(intersectSorted(a.data(), 0, b.data(), 6) == 0);
+    REQUIRE(intersectSorted(a.data(), 5, b.data(), 6) == 0);
+  }
+
+  SECTION("Matches std::set_intersection for mixed sizes") {
+    for (auto [na, nb] : {std::pair{7, 9}, std::pair{64, 80},
+                          std::pair{300, 310}, std::pair{5, 2000}}) {
+      auto a = randomSortedSet(na, 500, na);
+      auto b = randomSortedSet(nb, 500, nb + 1);
+
+      std::vector<int> expected;
+      std::set_intersection(a.begin(), a.end(), b.begin(), b.end(),
+                            std::back_inserter(expected));
+
+      std::vector<int> out(std::min(a.size(), b.size()));
+      const int count = intersectSorted(a.data(), static_cast<int>(a.size()),
+                                        b.data(), static_cast<int>(b.size()),
+                                        out.data());
+      out.resize(count);
+
+      REQUIRE(out == expected);
+      REQUIRE(intersectSorted(b.data(), static_cast<int>(b.size()), a.data(),
+                              static_cast<int>(a.size())) == count);
+    }
+  }
+}
+
+TEST_CASE("intersectsSorted", "[SetIntersection]") {
+  std::vector<int> a = {1, 4, 9, 12};
+  std::vector<int> b = {2, 3, 12, 20};
+  std::vector<int> c = {13, 14};
+
+  REQUIRE(intersectsSorted(a.data(), 4, b.data(), 4));
+  REQUIRE_FALSE(intersectsSorted(a.data(), 3, b.data(), 4));
+  REQUIRE_FALSE(intersectsSorted(a.data(), 4, c.data(), 2));
+  REQUIRE_FALSE(intersectsSorted(a.data(), 0, b.data(), 4));
+
+  for (int seed = 0; seed < 20; ++seed) {
+    auto x = randomSortedSet(30, 400, seed);
+    auto y = randomSortedSet(30, 400, seed + 100);
+    const bool expected = intersectSorted(x.data(), 30, y.data(), 30) > 0;
+    REQUIRE(intersectsSorted(x.data(), 30, y.data(), 30) == expected);
+  }
+}
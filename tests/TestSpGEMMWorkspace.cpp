@@ -0,0 +1,101 @@
+#define CATCH_CONFIG_MAIN
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "../include/CSRMatrix.h"
+#include "../include/CoordListMatrix.h"
+#include "../include/MatrixUtils.h"
+#include "../include/SpGEMMWorkspace.h"
+
+TEST_CASE("SpGEMMWorkspace construction", "[SpGEMMWorkspace]") {
+  REQUIRE_THROWS_AS(SpGEMMWorkspace(0), std::invalid_argument);
+
+  SpGEMMWorkspace ws(3);
+  REQUIRE(ws.numThreads() == 3);
+  REQUIRE_NOTHROW(ws.scratch(2));
+  REQUIRE_THROWS_AS(ws.scratch(3), std::out_of_range);
+  REQUIRE_THROWS_AS(ws.scratch(-1), std::out_of_range);
+
+  ws.reserve(100, 50, 1000);
+  REQUIRE(ws.scratch(1).marker.stamp.size() >= 100);
+  REQUIRE(ws.scratch(1).colIdx.capacity() >= 1000);
+
+  ws.release();
+  REQUIRE(ws.numThreads() == 3);
+  REQUIRE(ws.scratch(1).colIdx.capacity() == 0);
+}
+
+TEST_CASE("MarkerArray stamps", "[SpGEMMWorkspace]") {
+  MarkerArray marker;
+  marker.ensureSize(10);
+
+  uint32_t first = marker.next();
+  marker.stamp[4] = first;
+  uint32_t second = marker.next();
+
+  REQUIRE(first != second);
+  REQUIRE(marker.stamp[4] != second);
+}
+
+TEST_CASE("CSRMatrix matmul with workspace", "[SpGEMMWorkspace]") {
+  int M = 200, K = 150, N = 180;
+  CSRMatrix A(generateSparseMatrix(0.03, M, K, 1), M, K);
+  CSRMatrix B(generateSparseMatrix(0.03, K, N, 2), K, N);
+  CSRMatrix B2(generateSparseMatrix(0.02, K, N, 3), K, N);
+
+  SpGEMMWorkspace ws;
+
+  SECTION("Check mismatch error thrown") {
+    CSRMatrix bad(generateSparseMatrix(0.05, 10, N, 4), 10, N);
+    REQUIRE_THROWS_AS(A.naiveMatmul(bad, ws), std::invalid_argument);
+    REQUIRE_THROWS_AS(A.optimizedMatmul(bad, 100.0, ws),
+                      std::invalid_argument);
+  }
+
+  SECTION("Results match and buffers are reused across calls") {
+    CSRMatrix C = A.naiveMatmul(B, ws);
+    REQUIRE(C.shape() == std::pair<int, int>(M, N));
+    REQUIRE(C.getCoords() == A.naiveMatmul(B).getCoords());
+
+    const int *colBuffer = ws.scratch().colIdx.data();
+    const size_t capacity = ws.scratch().colIdx.capacity();
+
+    // A smaller product fits in the buffers grown by the first one
+    CSRMatrix C2 = A.optimizedMatmul(B2, 10.0, ws);
+    REQUIRE(C2.getCoords() == A.naiveMatmul(B2).getCoords());
+    REQUIRE(ws.scratch().colIdx.data() == colBuffer);
+    REQUIRE(ws.scratch().colIdx.capacity() == capacity);
+  }
+}
+
+TEST_CASE("CoordListMatrix matmul with workspace", "[SpGEMMWorkspace]") {
+  int M = 200, K = 150, N = 180;
+  CoordListMatrix A(generateSparseMatrix(0.03, M, K, 1), M, K);
+  CoordListMatrix B(generateSparseMatrix(0.03, K, N, 2), K, N);
+
+  SpGEMMWorkspace ws;
+
+  SECTION("Check mismatch error thrown") {
+    CoordListMatrix bad(generateSparseMatrix(0.05, 10, N, 4), 10, N);
+    REQUIRE_THROWS_AS(A.naiveMatmul(bad, ws), std::invalid_argument);
+    REQUIRE_THROWS_AS(A.optimizedMatmul(bad, 100.0, ws),
+                      std::invalid_argument);
+  }
+
+  SECTION("Results match the default overloads") {
+    auto expected = A.naiveMatmul(B).getCoords();
+    std::sort(expected.begin(), expected.end(),
+              [](const Coord &a, const Coord &b) {
+                return a.row != b.row ? a.row < b.row : a.col < b.col;
+              });
+
+    for (int call = 0; call < 2; ++call) {
+      CoordListMatrix C = A.naiveMatmul(B, ws);
+      REQUIRE(C.shape() == std::pair<int, int>(M, N));
+      REQUIRE(C.getCoords() == expected);
+
+      CoordListMatrix C2 = A.optimizedMatmul(B, 100.0, ws);
+      REQUIRE(C2.getCoords() == expected);
+    }
+  }
+}
@@ -0,0 +1,113 @@
+#define CATCH_CONFIG_MAIN
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "../include/CSRMatrix.h"
+#include "../include/MatrixUtils.h"
+#include "../include/TriangleCounting.h"
+
+// Symmetric adjacency from a random edge list, without self loops
+static std::vector<Coord> randomUndirectedGraph(int n, double density,
+                                                int seed) {
+  std::vector<Coord> coords;
+  for (const auto &[r, c] : generateSparseMatrix(density, n, n, seed)) {
+    if (r != c) {
+      coords.push_back({r, c});
+      coords.push_back({c, r});
+    }
+  }
+  std::sort(coords.begin(), coords.end(), [](const Coord &a, const Coord &b) {
+    return a.row != b.row ? a.row < b.row : a.col < b.col;
+  });
+  coords.erase(std::unique(coords.begin(), coords.end()), coords.end());
+  return coords;
+}
+
+TEST_CASE("countTriangles", "[TriangleCounting]") {
+  SECTION("Non-square adjacency throws invalid_argument") {
+    CSRMatrix A(generateSparseMatrix(0.1, 10, 12, 1), 10, 12);
+    REQUIRE_THROWS_AS(countTriangles(A), std::invalid_argument);
+  }
+
+  SECTION("Complete graph on 4 vertices, one direction stored") {
+    std::vector<Coord> edges = {{0, 1}, {0, 2}, {0, 3},
+                                {1, 2}, {1, 3}, {2, 3}};
+    CSRMatrix A(edges, 4, 4);
+
+    TriangleCounts counts = countTriangles(A);
+    REQUIRE(counts.total == 4);
+    REQUIRE(counts.perVertex == std::vector<int64_t>{3, 3, 3, 3});
+  }
+
+  SECTION("Matches brute force on a random graph") {
+    int n = 80;
+    auto coords = randomUndirectedGraph(n, 0.08, 7);
+    CSRMatrix A(coords, n, n);
+
+    std::vector<std::vector<bool>> adj(n, std::vector<bool>(n, false));
+    for (const auto &[r, c] : coords) {
+      adj[r][c] = true;
+    }
+    int64_t expectedTotal = 0;
+    std::vector<int64_t> expectedPerVertex(n, 0);
+    for (int u = 0; u < n; ++u) {
+      for (int v = u + 1; v < n; ++v) {
+        for (int w = v + 1; w < n; ++w) {
+          if (adj[u][v] && adj[v][w] && adj[u][w]) {
+            expectedTotal++;
+            expectedPerVertex[u]++;
+            expectedPerVertex[v]++;
+            expectedPerVertex[w]++;
+          }
+        }
+      }
+    }
+
+    for (int threads : {1, 3}) {
+      TriangleCounts counts = countTriangles(A, threads);
+      REQUIRE(counts.total == expectedTotal);
+      REQUIRE(counts.perVertex == expectedPerVertex);
+    }
+  }
+}
+
+TEST_CASE("countCommonNeighbors", "[TriangleCounting]") {
+  int n = 60;
+  CSRMatrix A(randomUndirectedGraph(n, 0.1, 3), n, n);
+
+  SECTION("Out-of-range pair throws out_of_range") {
+    std::vector<Coord> pairs = {{0, n}};
+    REQUIRE_THROWS_AS(countCommonNeighbors(A, pairs), std::out_of_range);
+  }
+
+  SECTION("Valued adjacency throws invalid_argument") {
+    CSRMatrix valued(A.getRowPtr(), A.getColIdx(),
+                     std::vector<double>(A.getColIdx().size(), 2.0), n, n);
+    REQUIRE_THROWS_AS(countTriangles(valued), std::invalid_argument);
+    REQUIRE_THROWS_AS(countCommonNeighbors(valued, {{0, 1}}),
+                      std::invalid_argument);
+  }
+
+  SECTION("Matches brute force on every pair") {
+    std::vector<Coord> pairs;
+    for (int u = 0; u < n; ++u) {
+      for (int v = 0; v < n; ++v) {
+        pairs.push_back({u, v});
+      }
+    }
+    auto counts = countCommonNeighbors(A, pairs, 2);
+
+    const auto &rowPtr = A.getRowPtr();
+    const auto &colIdx = A.getColIdx();
+    for (size_t i = 0; i < pairs.size(); ++i) {
+      const auto &[u, v] = pairs[i];
+      int expected = 0;
+      for (int p = rowPtr[u]; p < rowPtr[u + 1]; ++p) {
+        for (int q = rowPtr[v]; q < rowPtr[v + 1]; ++q) {
+          expected += colIdx[p] == colIdx[q];
+        }
+      }
+      REQUIRE(counts[i] == expected);
+    }
+  }
+}
@@ -0,0 +1,70 @@
+#define CATCH_CONFIG_MAIN
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "../include/ProductPlanner.h"
+#include "../include/Tuning.h"
+#include <cstdio>
+#include <fstream>
+
+TEST_CASE("Tuning file round trip", "[Tuning]") {
+  const std::string path = "test_tuning.cfg";
+
+  SECTION("Saved thresholds load back exactly") {
+    KernelThresholds t;
+    t.bitmapRowDensity = 0.0123456789;
+    t.denseProductDensity = 0.2;
+    t.flopsPerThread = 123456789012;
+    t.outerProductCompression = 2.75;
+    t.chunksPerThread = 3;
+    saveKernelThresholds(t, path);
+
+    KernelThresholds loaded = loadKernelThresholds(path);
+    REQUIRE(loaded.bitmapRowDensity == t.bitmapRowDensity);
+    REQUIRE(loaded.denseProductDensity == t.denseProductDensity);
+    REQUIRE(loaded.flopsPerThread == t.flopsPerThread);
+    REQUIRE(loaded.outerProductCompression == t.outerProductCompression);
+    REQUIRE(loaded.chunksPerThread == t.chunksPerThread);
+  }
+
+  SECTION("Keys left out keep their defaults") {
+    std::ofstream(path) << "# partial\n\n  chunksPerThread = 16\n";
+    KernelThresholds loaded = loadKernelThresholds(path);
+    REQUIRE(loaded.chunksPerThread == 16);
+    REQUIRE(loaded.flopsPerThread == KernelThresholds{}.flopsPerThread);
+  }
+
+  SECTION("Bad files throw") {
+    REQUIRE_THROWS_AS(loadKernelThresholds("no_such_tuning.cfg"),
+                      std::runtime_error);
+    std::ofstream(path) << "chunkPerThread = 16\n";
+    REQUIRE_THROWS_AS(loadKernelThresholds(path), std::runtime_error);
+    std::ofstream(path) << "chunksPerThread = 16x\n";
+    REQUIRE_THROWS_AS(loadKernelThresholds(path), std::runtime_error);
+    std::ofstream(path) << "denseProductDensity = 1.5\n";
+    REQUIRE_THROWS_AS(loadKernelThresholds(path), std::invalid_argument);
+  }
+
+  std::remove(path.c_str());
+}
+
+TEST_CASE("setKernelThresholds", "[Tuning]") {
+  const KernelThresholds saved = kernelThresholds();
+
+  KernelThresholds bad;
+  bad.chunksPerThread = 0;
+  REQUIRE_THROWS_AS(setKernelThresholds(bad), std::invalid_argument);
+
+  // Format choice follows the thresholds in effect
+  KernelThresholds t;
+  t.bitmapRowDensity = 0.001;
+  t.denseProductDensity = 0.5;
+  setKernelThresholds(t);
+  REQUIRE(chooseProductFormat(5000, 1000, 1000) == ProductFormat::BitmapRows);
+  REQUIRE(chooseProductFormat(300000, 1000, 1000) ==
+          ProductFormat::BitmapRows);
+
+  setKernelThresholds(KernelThresholds{});
+  REQUIRE(chooseProductFormat(5000, 1000, 1000) == ProductFormat::CSR);
+  setKernelThresholds(saved);
+}